@@ -0,0 +1,149 @@
+/**
+ * @file arene.c
+ * @brief Bump-pointer arena allocator for short-lived allocations freed all at once.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "arene.h"
+
+/// Size of the header of a block, rounded up so that the memory after it is aligned
+#define ENTETE_BLOC ((sizeof(bloc_arene) + ALIGNEMENT_ARENE - 1) / ALIGNEMENT_ARENE * ALIGNEMENT_ARENE)
+
+/// Largest size an arena can allocate, so that rounding it and adding a header does not overflow
+#define TAILLE_MAX_ARENE (SIZE_MAX - ENTETE_BLOC - ALIGNEMENT_ARENE)
+
+/**
+ * @brief Returns the memory of a block.
+ */
+static unsigned char *memoire(bloc_arene *bloc)
+{
+    return (unsigned char *) bloc + ENTETE_BLOC;
+}
+
+/**
+ * @brief Rounds a size up to a multiple of ALIGNEMENT_ARENE, a size of 0 taking ALIGNEMENT_ARENE bytes so that
+ *        every allocation has its own address.
+ */
+static size_t arrondir(size_t taille)
+{
+    if (taille == 0)
+        return ALIGNEMENT_ARENE;
+    return (taille + ALIGNEMENT_ARENE - 1) / ALIGNEMENT_ARENE * ALIGNEMENT_ARENE;
+}
+
+/**
+ * @brief Initialises an empty arena, without allocating anything yet.
+ *
+ * @param arene The arena.
+ * @param taille_bloc The size of its first block in bytes, or 0 for TAILLE_BLOC_ARENE.
+ */
+void arene_initialiser(arene_t *arene, size_t taille_bloc)
+{
+    arene->bloc = NULL;
+    arene->utilise = 0;
+    arene->taille_bloc = taille_bloc ? taille_bloc : TAILLE_BLOC_ARENE;
+    arene->derniere = NULL;
+}
+
+/**
+ * @brief Allocates memory from the arena, aligned on ALIGNEMENT_ARENE.
+ *
+ * @return The memory, or NULL if memory allocation failed.
+ */
+void *arene_allouer(arene_t *arene, size_t taille)
+{
+    if (taille > TAILLE_MAX_ARENE)
+        return NULL;
+    size_t arrondie = arrondir(taille);
+
+    if (!arene->bloc || arene->bloc->taille - arene->utilise < arrondie)
+    {
+        size_t taille_bloc = arene->taille_bloc;
+        if (arene->bloc)
+            taille_bloc = arene->bloc->taille > TAILLE_MAX_ARENE / 2 ? TAILLE_MAX_ARENE : arene->bloc->taille * 2;
+        if (taille_bloc < arrondie)
+            taille_bloc = arrondie;
+
+        bloc_arene *bloc = malloc(ENTETE_BLOC + taille_bloc);
+        if (!bloc)
+            return NULL;
+        bloc->precedent = arene->bloc;
+        bloc->taille = taille_bloc;
+        arene->bloc = bloc;
+        arene->utilise = 0;
+    }
+
+    void *allocation = memoire(arene->bloc) + arene->utilise;
+    arene->utilise += arrondie;
+    arene->derniere = allocation;
+    return allocation;
+}
+
+/**
+ * @brief Resizes an allocation of the arena: in place if it is the last one and its block has room, otherwise
+ *        by copying it to a new allocation, the old one staying allocated until the arena is reset.
+ *
+ * @param arene The arena.
+ * @param ancienne The allocation, or NULL to allocate.
+ * @param ancienne_taille Its size in bytes.
+ * @param taille The new size in bytes.
+ * @return The allocation resized, or NULL if memory allocation failed, the old one being left unchanged.
+ */
+void *arene_reallouer(arene_t *arene, void *ancienne, size_t ancienne_taille, size_t taille)
+{
+    if (!ancienne)
+        return arene_allouer(arene, taille);
+    if (taille > TAILLE_MAX_ARENE)
+        return NULL;
+
+    if (ancienne == arene->derniere)
+    {
+        size_t debut = (size_t) ((unsigned char *) ancienne - memoire(arene->bloc));
+        if (arrondir(taille) <= arene->bloc->taille - debut)
+        {
+            arene->utilise = debut + arrondir(taille);
+            return ancienne;
+        }
+    }
+    if (taille <= ancienne_taille)
+        return ancienne;
+
+    void *nouvelle = arene_allouer(arene, taille);
+    if (!nouvelle)
+        return NULL;
+    memcpy(nouvelle, ancienne, ancienne_taille);
+    return nouvelle;
+}
+
+/**
+ * @brief Releases everything allocated from the arena, keeping its largest block for the next allocations.
+ */
+void arene_reinitialiser(arene_t *arene)
+{
+    if (!arene->bloc)
+        return;
+
+    // the blocks only grow, the one being filled is the largest
+    bloc_arene *bloc = arene->bloc->precedent;
+    while (bloc)
+    {
+        bloc_arene *precedent = bloc->precedent;
+        free(bloc);
+        bloc = precedent;
+    }
+    arene->bloc->precedent = NULL;
+    arene->utilise = 0;
+    arene->derniere = NULL;
+}
+
+/**
+ * @brief Frees all the blocks of the arena.
+ */
+void arene_detruire(arene_t *arene)
+{
+    arene_reinitialiser(arene);
+    free(arene->bloc);
+    arene->bloc = NULL;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file arene.h
+ * @brief Bump-pointer arena allocator for short-lived allocations freed all at once.
+ *
+ * An arena hands out memory from large blocks by moving a pointer forward; there is no per-allocation free.
+ * Everything allocated from it is released at once by arene_reinitialiser, which keeps the largest block for
+ * the next round, or by arene_detruire. This suits the data whose lifetime is one step of a loop: the parsed
+ * command line of a prompt, the scratch buffers of one image or of one file of an archive.
+ *
+ * A block that is too small for a request is chained to a new one, at least twice as large and large enough
+ * for the request, so that a round of n bytes allocates O(log n) blocks; after a reset, the next round of the
+ * same size fits in the block kept.
+ */
+
+#ifndef R305_ARENE_H
+#define R305_ARENE_H
+
+#include <stddef.h>
+
+/// Size of the first block of an arena initialised with a size of 0
+#define TAILLE_BLOC_ARENE 4096
+
+/// Alignment of every allocation, the one of malloc
+#define ALIGNEMENT_ARENE _Alignof(max_align_t)
+
+/// A block of an arena, followed by its memory
+typedef struct bloc_arene
+{
+    struct bloc_arene *precedent;  ///< the block filled before this one
+    size_t taille;                 ///< number of bytes of memory after the header
+} bloc_arene;
+
+/// An arena
+typedef struct
+{
+    bloc_arene *bloc;       ///< the block being filled, NULL before the first allocation
+    size_t utilise;         ///< number of bytes used in the block being filled
+    size_t taille_bloc;     ///< size of the first block
+    void *derniere;         ///< the last allocation, which arene_reallouer can grow in place
+} arene_t;
+
+/**
+ * @brief Initialises an empty arena, without allocating anything yet.
+ *
+ * @param arene The arena.
+ * @param taille_bloc The size of its first block in bytes, or 0 for TAILLE_BLOC_ARENE.
+ */
+void arene_initialiser(arene_t *arene, size_t taille_bloc);
+
+/**
+ * @brief Allocates memory from the arena, aligned on ALIGNEMENT_ARENE.
+ *
+ * @return The memory, or NULL if memory allocation failed.
+ */
+void *arene_allouer(arene_t *arene, size_t taille);
+
+/**
+ * @brief Resizes an allocation of the arena: in place if it is the last one and its block has room, otherwise
+ *        by copying it to a new allocation, the old one staying allocated until the arena is reset.
+ *
+ * @param arene The arena.
+ * @param ancienne The allocation, or NULL to allocate.
+ * @param ancienne_taille Its size in bytes.
+ * @param taille The new size in bytes.
+ * @return The allocation resized, or NULL if memory allocation failed, the old one being left unchanged.
+ */
+void *arene_reallouer(arene_t *arene, void *ancienne, size_t ancienne_taille, size_t taille);
+
+/**
+ * @brief Releases everything allocated from the arena, keeping its largest block for the next allocations.
+ */
+void arene_reinitialiser(arene_t *arene);
+
+/**
+ * @brief Frees all the blocks of the arena.
+ */
+void arene_detruire(arene_t *arene);
+
+#endif //R305_ARENE_H
@@ -56,8 +56,8 @@ int main(int const argc, char *argv[])
                 run_infinite_fork();
 
             case 'd':
-                run_queue_and_stack_operations();
-                break;
+                // the options following it are options of --queue_and_stack_operations, not of the program
+                return run_queue_and_stack_operations(argc - 1, argv + 1) == 0 ? 0 : 1;
 
             case 'e':
                 run_archiver(argc - 1, argv + 1);
@@ -72,8 +72,12 @@ int main(int const argc, char *argv[])
                 break;
 
             case 'h':
-                run_shell();
-                break;
+            {
+                // the arguments following it are -c COMMANDS or a script of --shell, not options of the program;
+                // the program exits with the status of the last command line, as a shell does
+                int const status = run_shell(argc - 1, argv + 1);
+                return status == -1 ? 1 : status;
+            }
 
             case 'j':
                 run_encodeur(argc - 1, argv + 1);
@@ -84,8 +88,8 @@ int main(int const argc, char *argv[])
                 break;
 
             case 'l':
-                run_modif_bmp(argc - 1, argv + 1);
-                break;
+                // the filters following the files are options of --modif_bmp, not of the program
+                return run_modif_bmp(argc - 1, argv + 1) == 0 ? 0 : 1;
 
             case 'm':
                 run_filtre(argc - 1, argv + 1);
@@ -104,11 +108,11 @@ int main(int const argc, char *argv[])
                 printf("Options:\n");
                 printf("%30s\tDeploys an infinite memory allocation operation\n", "--infinite_malloc");
                 printf("%30s\tDeploys an infinite thread forking operation\n", "--infinite_fork");
-                printf("%30s\tExercises queue and stack operations\n", "--queue_and_stack_operations");
+                printf("%30s\tTests and benchmarks the queues and stacks\n", "--queue_and_stack_operations");
                 printf("%30s\tArchives files or directories\n", "--archiver");
                 printf("%30s\tExtracts files or directories from an archive\n", "--unarchiver");
                 printf("%30s\tLists the directory contents\n", "--ls");
-                printf("%30s\tOpens an internal shell for command execution\n", "--shell");
+                printf("%30s\tOpens an internal shell for command execution, or runs -c COMMANDS or a script\n", "--shell");
                 printf("%30s\tEncodes provided data\n", "--encoder");
                 printf("%30s\tDecodes previously encoded data\n", "--decoder");
                 printf("%30s\tModifies a bmp image file\n", "--modif_bmp");
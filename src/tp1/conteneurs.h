@@ -0,0 +1,307 @@
+/**
+ * @file conteneurs.h
+ * @brief Stacks and queues of any element type, generated by macros.
+ *
+ * Each macro defines a container type `nom_t` and its operations `nom_...`, all static inline so that every
+ * call is compiled for the element type and can be inlined as a hand-written container would be. Elements are
+ * moved with memcpy, so any type can be stored: integers, pointers or structures. The storage is chosen with
+ * the macro: a fixed-size array inside the container, or an array allocated on the heap that grows and
+ * shrinks with the number of elements.
+ *
+ * All operations but the display follow the conventions of the int containers of
+ * queue_and_stack_operations.h, which are instantiations of these macros: they return 0 on success and -1
+ * when the container is full, empty, or memory allocation failed, a failed operation leaving the container
+ * unchanged.
+ */
+
+#ifndef R305_CONTENEURS_H
+#define R305_CONTENEURS_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+
+/**
+ * @brief Defines a stack of at most `capacite` elements of type T, stored in the stack itself.
+ *
+ * Defines nom_t and nom_initialiser, nom_est_vide, nom_empiler and nom_depiler.
+ */
+#define DEFINIR_PILE_FIXE(nom, T, capacite) \
+    typedef struct \
+    { \
+        T pile[capacite];  /* les éléments, du fond au sommet */ \
+        int sommet;        /* l'indice du dernier élément empilé */ \
+    } nom##_t; \
+    \
+    static inline void nom##_initialiser(nom##_t *pile) \
+    { \
+        pile->sommet = -1; \
+    } \
+    \
+    static inline int nom##_est_vide(const nom##_t *pile) \
+    { \
+        return pile->sommet == -1 ? 1 : 0; \
+    } \
+    \
+    static inline int nom##_empiler(nom##_t *pile, T const element) \
+    { \
+        if (pile->sommet >= (capacite) - 1) \
+            return -1; \
+        memcpy(&pile->pile[++pile->sommet], &element, sizeof(T)); \
+        return 0; \
+    } \
+    \
+    static inline int nom##_depiler(nom##_t *pile, T *p_element) \
+    { \
+        if (nom##_est_vide(pile)) \
+            return -1; \
+        memcpy(p_element, &pile->pile[pile->sommet--], sizeof(T)); \
+        return 0; \
+    }
+
+/**
+ * @brief Defines a stack of elements of type T stored in an array on the heap.
+ *
+ * The array starts with `taille_initiale` elements, doubles when it is full and is halved when it is a quarter
+ * full, never below `taille_initiale` nor below the size reserved by nom_reserver.
+ *
+ * Defines nom_t and nom_initialiser, nom_est_vide, nom_empiler, nom_depiler, nom_reserver (grows the array to
+ * a number of elements and keeps it from shrinking below), nom_ajuster (shrinks the array to the elements and
+ * cancels the reservation) and nom_detruire.
+ */
+#define DEFINIR_PILE(nom, T, taille_initiale) \
+    typedef struct \
+    { \
+        T *pile;      /* les éléments, du fond au sommet */ \
+        int sommet;   /* l'indice du dernier élément empilé */ \
+        int taille;   /* la taille du tableau pile */ \
+        int minimum;  /* la taille en dessous de laquelle la pile ne rétrécit pas */ \
+    } nom##_t; \
+    \
+    static inline int nom##_initialiser(nom##_t *pile) \
+    { \
+        pile->sommet = -1; \
+        pile->taille = (taille_initiale); \
+        pile->minimum = (taille_initiale); \
+        pile->pile = malloc(sizeof(T) * pile->taille); \
+        return pile->pile ? 0 : -1; \
+    } \
+    \
+    static inline int nom##_est_vide(const nom##_t *pile) \
+    { \
+        return pile->sommet == -1 ? 1 : 0; \
+    } \
+    \
+    /* the stack keeps its array if the reallocation fails */ \
+    static inline int nom##_redimensionner(nom##_t *pile, int taille) \
+    { \
+        if ((size_t) taille > SIZE_MAX / sizeof(T)) \
+            return -1; \
+        T *tableau = realloc(pile->pile, sizeof(T) * taille); \
+        if (!tableau) \
+            return -1; \
+        pile->pile = tableau; \
+        pile->taille = taille; \
+        return 0; \
+    } \
+    \
+    static inline int nom##_empiler(nom##_t *pile, T const element) \
+    { \
+        if (pile->sommet >= pile->taille - 1 \
+            && (pile->taille > INT_MAX / 2 || nom##_redimensionner(pile, pile->taille * 2) == -1)) \
+            return -1; \
+        memcpy(&pile->pile[++pile->sommet], &element, sizeof(T)); \
+        return 0; \
+    } \
+    \
+    static inline int nom##_depiler(nom##_t *pile, T *p_element) \
+    { \
+        if (nom##_est_vide(pile)) \
+            return -1; \
+        memcpy(p_element, &pile->pile[pile->sommet--], sizeof(T)); \
+        /* half full once halved: pushing and popping around a size never reallocates */ \
+        if (pile->sommet + 1 <= pile->taille / 4 && pile->taille / 2 >= pile->minimum) \
+            nom##_redimensionner(pile, pile->taille / 2); \
+        return 0; \
+    } \
+    \
+    static inline int nom##_reserver(nom##_t *pile, int capacite) \
+    { \
+        if (capacite > pile->taille && nom##_redimensionner(pile, capacite) == -1) \
+            return -1; \
+        if (capacite > pile->minimum) \
+            pile->minimum = capacite; \
+        return 0; \
+    } \
+    \
+    static inline int nom##_ajuster(nom##_t *pile) \
+    { \
+        pile->minimum = (taille_initiale); \
+        return nom##_redimensionner(pile, pile->sommet >= 0 ? pile->sommet + 1 : 1); \
+    } \
+    \
+    static inline void nom##_detruire(nom##_t *pile) \
+    { \
+        free(pile->pile); \
+        pile->pile = NULL; \
+        pile->sommet = -1; \
+        pile->taille = 0; \
+        pile->minimum = (taille_initiale); \
+    }
+
+/**
+ * @brief Defines a queue of at most `capacite` elements of type T, stored in a ring inside the queue itself.
+ *
+ * Defines nom_t and nom_initialiser, nom_est_vide, nom_enfiler and nom_defiler.
+ */
+#define DEFINIR_FILE_FIXE(nom, T, capacite) \
+    typedef struct \
+    { \
+        T file[capacite];  /* les éléments, en anneau */ \
+        int head;          /* l'indice du premier élément */ \
+        int tail;          /* l'indice de la case qui suit le dernier élément */ \
+        int nombre;        /* le nombre d'éléments dans la file */ \
+    } nom##_t; \
+    \
+    static inline void nom##_initialiser(nom##_t *file) \
+    { \
+        file->head = 0; \
+        file->tail = 0; \
+        file->nombre = 0; \
+    } \
+    \
+    static inline int nom##_est_vide(const nom##_t *file) \
+    { \
+        return file->nombre == 0 ? 1 : 0; \
+    } \
+    \
+    static inline int nom##_enfiler(nom##_t *file, T const element) \
+    { \
+        if (file->nombre == (capacite)) \
+            return -1; \
+        memcpy(&file->file[file->tail], &element, sizeof(T)); \
+        file->tail = file->tail + 1 == (capacite) ? 0 : file->tail + 1; \
+        file->nombre++; \
+        return 0; \
+    } \
+    \
+    static inline int nom##_defiler(nom##_t *file, T *p_element) \
+    { \
+        if (nom##_est_vide(file)) \
+            return -1; \
+        memcpy(p_element, &file->file[file->head], sizeof(T)); \
+        file->head = file->head + 1 == (capacite) ? 0 : file->head + 1; \
+        file->nombre--; \
+        return 0; \
+    }
+
+/**
+ * @brief Defines a queue of elements of type T stored in a ring allocated on the heap.
+ *
+ * The ring starts with `taille_initiale` elements, doubles when it is full and is halved when it is a quarter
+ * full, never below `taille_initiale`. Growing moves the smaller of the two parts of the ring that wrap
+ * around the former end of the array, so that every operation is amortized O(1).
+ *
+ * Defines nom_t and nom_initialiser, nom_est_vide, nom_enfiler, nom_defiler and nom_detruire.
+ */
+#define DEFINIR_FILE(nom, T, taille_initiale) \
+    typedef struct \
+    { \
+        T *file;      /* les éléments, en anneau */ \
+        int head;     /* l'indice du premier élément */ \
+        int tail;     /* l'indice de la case qui suit le dernier élément */ \
+        int nombre;   /* le nombre d'éléments dans la file */ \
+        int taille;   /* la taille du tableau file */ \
+    } nom##_t; \
+    \
+    static inline int nom##_initialiser(nom##_t *file) \
+    { \
+        file->taille = (taille_initiale); \
+        file->head = 0; \
+        file->tail = 0; \
+        file->nombre = 0; \
+        file->file = malloc(sizeof(T) * file->taille); \
+        return file->file ? 0 : -1; \
+    } \
+    \
+    static inline int nom##_est_vide(const nom##_t *file) \
+    { \
+        return file->nombre == 0 ? 1 : 0; \
+    } \
+    \
+    /* the queue is full, so its tail is its head: [head, ancienne) then [0, tail) hold the elements */ \
+    static inline int nom##_agrandir(nom##_t *file) \
+    { \
+        int ancienne = file->taille; \
+        if (ancienne > INT_MAX / 2 || (size_t) ancienne * 2 > SIZE_MAX / sizeof(T)) \
+            return -1; \
+        T *tableau = realloc(file->file, sizeof(T) * ancienne * 2); \
+        if (!tableau) \
+            return -1; \
+        file->file = tableau; \
+        file->taille = ancienne * 2; \
+        if (file->tail < ancienne - file->head) \
+        { \
+            memcpy(file->file + ancienne, file->file, sizeof(T) * file->tail); \
+            file->tail += ancienne; \
+        } else \
+        { \
+            memcpy(file->file + file->head + ancienne, file->file + file->head, \
+                   sizeof(T) * (ancienne - file->head)); \
+            file->head += ancienne; \
+        } \
+        return 0; \
+    } \
+    \
+    /* the queue keeps its array if the allocation fails */ \
+    static inline void nom##_reduire(nom##_t *file) \
+    { \
+        int taille = file->taille / 2; \
+        T *tableau = malloc(sizeof(T) * taille); \
+        if (!tableau) \
+            return; \
+        int premiers = file->taille - file->head < file->nombre ? file->taille - file->head : file->nombre; \
+        memcpy(tableau, file->file + file->head, sizeof(T) * premiers); \
+        memcpy(tableau + premiers, file->file, sizeof(T) * (file->nombre - premiers)); \
+        free(file->file); \
+        file->file = tableau; \
+        file->taille = taille; \
+        file->head = 0; \
+        file->tail = file->nombre == taille ? 0 : file->nombre; \
+    } \
+    \
+    static inline int nom##_enfiler(nom##_t *file, T const element) \
+    { \
+        if (file->nombre == file->taille && nom##_agrandir(file) == -1) \
+            return -1; \
+        memcpy(&file->file[file->tail], &element, sizeof(T)); \
+        file->tail = file->tail + 1 == file->taille ? 0 : file->tail + 1; \
+        file->nombre++; \
+        return 0; \
+    } \
+    \
+    static inline int nom##_defiler(nom##_t *file, T *p_element) \
+    { \
+        if (nom##_est_vide(file)) \
+            return -1; \
+        memcpy(p_element, &file->file[file->head], sizeof(T)); \
+        file->head = file->head + 1 == file->taille ? 0 : file->head + 1; \
+        file->nombre--; \
+        /* half full once halved: enfiling and defiling around a size never reallocates */ \
+        if (file->nombre <= file->taille / 4 && file->taille / 2 >= (taille_initiale)) \
+            nom##_reduire(file); \
+        return 0; \
+    } \
+    \
+    static inline void nom##_detruire(nom##_t *file) \
+    { \
+        free(file->file); \
+        file->file = NULL; \
+        file->head = 0; \
+        file->tail = 0; \
+        file->nombre = 0; \
+        file->taille = 0; \
+    }
+
+#endif //R305_CONTENEURS_H
@@ -0,0 +1,476 @@
+/**
+ * @file conteneurs_banc.c
+ * @brief Benchmark suite of the stacks and queues of int.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "conteneurs_banc.h"
+#include "file_spsc.h"
+#include "file_mpmc.h"
+#include "deque_vol.h"
+#include "file_blocs.h"
+
+DEFINIR_PILE_FIXE(pile_fixe_banc, element_t, CAPACITE_FIXE_BANC)
+DEFINIR_FILE_FIXE(file_fixe_banc, element_t, CAPACITE_FIXE_BANC)
+
+/// Names of the patterns in the reports
+static const char *noms_motifs[NB_MOTIFS] = {"push", "pop", "mixed"};
+
+static void *creer_pile_fixe(long long taille)
+{
+    (void) taille;
+    pile_fixe_banc_t *pile = malloc(sizeof(pile_fixe_banc_t));
+    if (pile)
+        pile_fixe_banc_initialiser(pile);
+    return pile;
+}
+
+static int ajouter_pile_fixe(void *pile, element_t element) { return pile_fixe_banc_empiler(pile, element); }
+static int retirer_pile_fixe(void *pile, element_t *p_element) { return pile_fixe_banc_depiler(pile, p_element); }
+
+static void *creer_pile_variable(long long taille)
+{
+    (void) taille;
+    pile_variable_t *pile = malloc(sizeof(pile_variable_t));
+    if (pile && pile_variable_initialiser(pile) == -1)
+    {
+        free(pile);
+        return NULL;
+    }
+    return pile;
+}
+
+static int ajouter_pile_variable(void *pile, element_t element) { return pile_variable_empiler(pile, element); }
+static int retirer_pile_variable(void *pile, element_t *p_element) { return pile_variable_depiler(pile, p_element); }
+
+static void detruire_pile_variable(void *pile)
+{
+    pile_variable_detruire(pile);
+    free(pile);
+}
+
+static void *creer_deque_vol(long long taille)
+{
+    (void) taille;
+    deque_vol_t *deque = aligned_alloc(TAILLE_LIGNE_CACHE, sizeof(deque_vol_t));
+    if (deque && deque_vol_initialiser(deque) == -1)
+    {
+        free(deque);
+        return NULL;
+    }
+    return deque;
+}
+
+static int ajouter_deque_vol(void *deque, element_t element)
+{
+    return deque_vol_empiler(deque, (void *) (intptr_t) element);
+}
+
+static int retirer_deque_vol(void *deque, element_t *p_element)
+{
+    void *element;
+    if (deque_vol_depiler(deque, &element) == -1)
+        return -1;
+    *p_element = (element_t) (intptr_t) element;
+    return 0;
+}
+
+static void detruire_deque_vol(void *deque)
+{
+    deque_vol_detruire(deque);
+    free(deque);
+}
+
+static void *creer_file_fixe(long long taille)
+{
+    (void) taille;
+    file_fixe_banc_t *file = malloc(sizeof(file_fixe_banc_t));
+    if (file)
+        file_fixe_banc_initialiser(file);
+    return file;
+}
+
+static int ajouter_file_fixe(void *file, element_t element) { return file_fixe_banc_enfiler(file, element); }
+static int retirer_file_fixe(void *file, element_t *p_element) { return file_fixe_banc_defiler(file, p_element); }
+
+static void *creer_file_variable(long long taille)
+{
+    (void) taille;
+    file_variable_t *file = malloc(sizeof(file_variable_t));
+    if (file && file_variable_initialiser(file) == -1)
+    {
+        free(file);
+        return NULL;
+    }
+    return file;
+}
+
+static int ajouter_file_variable(void *file, element_t element) { return file_variable_enfiler(file, element); }
+static int retirer_file_variable(void *file, element_t *p_element) { return file_variable_defiler(file, p_element); }
+
+static void detruire_file_variable(void *file)
+{
+    file_variable_detruire(file);
+    free(file);
+}
+
+static void *creer_file_blocs(long long taille)
+{
+    (void) taille;
+    file_blocs_t *file = malloc(sizeof(file_blocs_t));
+    if (file && file_blocs_initialiser(file) == -1)
+    {
+        free(file);
+        return NULL;
+    }
+    return file;
+}
+
+static int ajouter_file_blocs(void *file, element_t element) { return file_blocs_enfiler(file, element); }
+static int retirer_file_blocs(void *file, element_t *p_element) { return file_blocs_defiler(file, p_element); }
+
+static void detruire_file_blocs(void *file)
+{
+    file_blocs_detruire(file);
+    free(file);
+}
+
+static void *creer_file_spsc(long long taille)
+{
+    file_spsc_t *file = aligned_alloc(TAILLE_LIGNE_CACHE, sizeof(file_spsc_t));
+    if (file && file_spsc_initialiser(file, (size_t) taille) == -1)
+    {
+        free(file);
+        return NULL;
+    }
+    return file;
+}
+
+static int ajouter_file_spsc(void *file, element_t element) { return file_spsc_enfiler(file, element); }
+static int retirer_file_spsc(void *file, element_t *p_element) { return file_spsc_defiler(file, p_element); }
+
+static void detruire_file_spsc(void *file)
+{
+    file_spsc_detruire(file);
+    free(file);
+}
+
+static void *creer_file_mpmc(long long taille)
+{
+    file_mpmc_t *file = aligned_alloc(TAILLE_LIGNE_CACHE, sizeof(file_mpmc_t));
+    if (file && file_mpmc_initialiser(file, (size_t) taille) == -1)
+    {
+        free(file);
+        return NULL;
+    }
+    return file;
+}
+
+static int ajouter_file_mpmc(void *file, element_t element) { return file_mpmc_essayer_enfiler(file, element); }
+static int retirer_file_mpmc(void *file, element_t *p_element) { return file_mpmc_essayer_defiler(file, p_element); }
+
+static void detruire_file_mpmc(void *file)
+{
+    file_mpmc_detruire(file);
+    free(file);
+}
+
+/// The variants measured; the concurrent containers are used from a single thread
+static const variante_banc variantes[] = {
+        {"pile_fixe",     1, CAPACITE_FIXE_BANC, creer_pile_fixe,     ajouter_pile_fixe,     retirer_pile_fixe,     free},
+        {"pile_variable", 1, 0,                  creer_pile_variable, ajouter_pile_variable, retirer_pile_variable, detruire_pile_variable},
+        {"deque_vol",     1, 0,                  creer_deque_vol,     ajouter_deque_vol,     retirer_deque_vol,     detruire_deque_vol},
+        {"file_fixe",     0, CAPACITE_FIXE_BANC, creer_file_fixe,     ajouter_file_fixe,     retirer_file_fixe,     free},
+        {"file_variable", 0, 0,                  creer_file_variable, ajouter_file_variable, retirer_file_variable, detruire_file_variable},
+        {"file_blocs",    0, 0,                  creer_file_blocs,    ajouter_file_blocs,    retirer_file_blocs,    detruire_file_blocs},
+        {"file_spsc",     0, 0,                  creer_file_spsc,     ajouter_file_spsc,     retirer_file_spsc,     detruire_file_spsc},
+        {"file_mpmc",     0, 0,                  creer_file_mpmc,     ajouter_file_mpmc,     retirer_file_mpmc,     detruire_file_mpmc},
+};
+
+/**
+ * @brief Returns the current time of the monotonic clock in seconds.
+ */
+static double maintenant(void)
+{
+    struct timespec temps;
+    clock_gettime(CLOCK_MONOTONIC, &temps);
+    return temps.tv_sec + temps.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Returns the number of nanoseconds between two times of the monotonic clock.
+ */
+static double ecart_ns(const struct timespec *debut, const struct timespec *fin)
+{
+    return (double) (fin->tv_sec - debut->tv_sec) * 1e9 + (double) (fin->tv_nsec - debut->tv_nsec);
+}
+
+static int comparer_doubles(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Returns the median time of reading the clock twice, subtracted from the latencies sampled.
+ */
+static double surcout_horloge(void)
+{
+    double mesures[1001];
+    struct timespec debut, fin;
+
+    for (int i = 0; i < 1001; i++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &debut);
+        clock_gettime(CLOCK_MONOTONIC, &fin);
+        mesures[i] = ecart_ns(&debut, &fin);
+    }
+    qsort(mesures, 1001, sizeof(double), comparer_doubles);
+    return mesures[500];
+}
+
+/**
+ * @brief Measures a variant on a pattern at a size.
+ *
+ * The case is repeated until OPERATIONS_MIN_BANC operations are timed. Filling the container before the pops
+ * and emptying it afterwards are not timed. One operation out of every operations / ECHANTILLONS_BANC is
+ * timed on its own for the latencies, the others only as a whole for the throughput.
+ *
+ * @param variante The variant.
+ * @param motif The pattern.
+ * @param taille The size.
+ * @param resultat Receives the measures, but for the peak resident set size.
+ */
+static void mesurer(const variante_banc *variante, motif_banc motif, long long taille, resultat_banc *resultat)
+{
+    long long tours = (OPERATIONS_MIN_BANC + taille - 1) / taille;
+    long long pas = tours * taille / ECHANTILLONS_BANC + 1;
+    long long avant_echantillon = 1;
+    double *latences = malloc(sizeof(double) * ECHANTILLONS_BANC);
+    double surcout = surcout_horloge();
+    int echantillons = 0;
+    unsigned int alea = 2463534242u;
+    element_t e;
+
+    memset(resultat, 0, sizeof(resultat_banc));
+    if (!latences)
+    {
+        resultat->erreur = -1;
+        return;
+    }
+
+    for (long long tour = 0; tour < tours && resultat->erreur == 0; tour++)
+    {
+        void *conteneur = variante->creer(taille);
+        if (!conteneur)
+        {
+            resultat->erreur = -1;
+            break;
+        }
+
+        long long nombre = motif == MOTIF_AJOUTS ? 0 : motif == MOTIF_RETRAITS ? taille : taille / 2;
+        for (long long i = 0; i < nombre; i++)
+            resultat->erreur |= variante->ajouter(conteneur, (element_t) i);
+
+        double debut = maintenant();
+        for (long long i = 0; i < taille; i++)
+        {
+            struct timespec avant, apres;
+            int echantillon = --avant_echantillon == 0;
+            int ajout;
+
+            if (motif == MOTIF_MIXTE)
+            {
+                // xorshift32, a push or a pop with the same odds while the container is neither empty nor full
+                alea ^= alea << 13;
+                alea ^= alea >> 17;
+                alea ^= alea << 5;
+                ajout = nombre == 0 || (nombre < taille && (alea & 1));
+            } else
+                ajout = motif == MOTIF_AJOUTS;
+
+            if (echantillon)
+                clock_gettime(CLOCK_MONOTONIC, &avant);
+            if (ajout)
+            {
+                resultat->erreur |= variante->ajouter(conteneur, (element_t) nombre++);
+            } else
+            {
+                resultat->erreur |= variante->retirer(conteneur, &e);
+                nombre--;
+                // a stack gives back its elements in reverse order, a queue in order
+                if (motif == MOTIF_RETRAITS && e != (element_t) (variante->pile ? nombre : taille - 1 - nombre))
+                    resultat->erreur = -1;
+            }
+            if (echantillon)
+            {
+                clock_gettime(CLOCK_MONOTONIC, &apres);
+                latences[echantillons++] = ecart_ns(&avant, &apres) - surcout;
+                avant_echantillon = pas;
+            }
+        }
+        resultat->duree += maintenant() - debut;
+
+        while (nombre-- > 0)
+            resultat->erreur |= variante->retirer(conteneur, &e);
+        variante->detruire(conteneur);
+    }
+
+    resultat->operations = tours * taille;
+    if (echantillons > 0)
+    {
+        qsort(latences, echantillons, sizeof(double), comparer_doubles);
+        resultat->p50 = latences[echantillons * 50 / 100] > 0 ? latences[echantillons * 50 / 100] : 0;
+        resultat->p99 = latences[echantillons * 99 / 100] > 0 ? latences[echantillons * 99 / 100] : 0;
+    }
+    free(latences);
+}
+
+/**
+ * @brief Measures a case in a child process, so that its peak resident set size is its own and a failed
+ *        allocation of a large size only fails that case.
+ *
+ * @return 0 on success, -1 if the child could not be run or failed.
+ */
+static int executer_cas(const variante_banc *variante, motif_banc motif, long long taille, resultat_banc *resultat)
+{
+    int tube[2];
+
+    fflush(stdout);
+    if (pipe(tube) == -1)
+    {
+        perror("pipe");
+        return -1;
+    }
+
+    pid_t pid = fork();
+    if (pid == -1)
+    {
+        perror("fork");
+        close(tube[0]);
+        close(tube[1]);
+        return -1;
+    }
+
+    if (pid == 0)
+    {
+        struct rusage usage;
+
+        close(tube[0]);
+        mesurer(variante, motif, taille, resultat);
+        getrusage(RUSAGE_SELF, &usage);
+        resultat->rss_max = usage.ru_maxrss;
+        int ecrit = write(tube[1], resultat, sizeof(resultat_banc)) == (ssize_t) sizeof(resultat_banc);
+        _exit(ecrit ? 0 : 1);
+    }
+
+    close(tube[1]);
+    ssize_t lus = read(tube[0], resultat, sizeof(resultat_banc));
+    close(tube[0]);
+
+    int statut;
+    if (waitpid(pid, &statut, 0) == -1 || !WIFEXITED(statut) || WEXITSTATUS(statut) != 0
+        || lus != (ssize_t) sizeof(resultat_banc))
+    {
+        memset(resultat, 0, sizeof(resultat_banc));
+        resultat->erreur = -1;
+    }
+    return resultat->erreur;
+}
+
+/**
+ * @brief Writes the measures of a case to the report and to the CSV and JSON files that are open.
+ */
+static void rapporter(const variante_banc *variante, motif_banc motif, long long taille,
+                      const resultat_banc *resultat, FILE *csv, FILE *json, int premier)
+{
+    double debit = resultat->duree > 0 ? resultat->operations / resultat->duree : 0;
+    const char *statut = resultat->erreur == 0 ? "ok" : "error";
+
+    printf("%-14s %-5s %-6s %10lld %10.2f Mops/s  p50 %8.1f ns  p99 %8.1f ns  peak RSS %9ld KiB  %s\n",
+           variante->nom, variante->pile ? "stack" : "queue", noms_motifs[motif], taille, debit / 1e6,
+           resultat->p50, resultat->p99, resultat->rss_max, statut);
+
+    if (csv)
+        fprintf(csv, "%s,%s,%s,%lld,%lld,%.6f,%.0f,%.1f,%.1f,%ld,%s\n", variante->nom,
+                variante->pile ? "stack" : "queue", noms_motifs[motif], taille, resultat->operations,
+                resultat->duree, debit, resultat->p50, resultat->p99, resultat->rss_max, statut);
+    if (json)
+        fprintf(json, "%s\n    {\"container\": \"%s\", \"kind\": \"%s\", \"pattern\": \"%s\", \"size\": %lld, "
+                      "\"operations\": %lld, \"seconds\": %.6f, \"ops_per_sec\": %.0f, \"p50_ns\": %.1f, "
+                      "\"p99_ns\": %.1f, \"peak_rss_kib\": %ld, \"status\": \"%s\"}", premier ? "" : ",",
+                variante->nom, variante->pile ? "stack" : "queue", noms_motifs[motif], taille,
+                resultat->operations, resultat->duree, debit, resultat->p50, resultat->p99, resultat->rss_max,
+                statut);
+}
+
+/**
+ * @brief Runs the benchmark suite.
+ *
+ * @param taille_max The largest size measured.
+ * @param csv Path of the CSV file to write, or NULL.
+ * @param json Path of the JSON file to write, or NULL.
+ * @return 0 if every case succeeded, -1 otherwise.
+ */
+int banc_conteneurs(long long taille_max, const char *csv, const char *json)
+{
+    FILE *fichier_csv = NULL, *fichier_json = NULL;
+    int echecs = 0, premier = 1;
+
+    if (csv && !(fichier_csv = fopen(csv, "w")))
+    {
+        perror(csv);
+        return -1;
+    }
+    if (json && !(fichier_json = fopen(json, "w")))
+    {
+        perror(json);
+        if (fichier_csv)
+            fclose(fichier_csv);
+        return -1;
+    }
+
+    if (fichier_csv)
+        fprintf(fichier_csv, "container,kind,pattern,size,operations,seconds,ops_per_sec,p50_ns,p99_ns,"
+                             "peak_rss_kib,status\n");
+    if (fichier_json)
+        fprintf(fichier_json, "{\n  \"benchmark\": \"queue_and_stack_operations\",\n  \"results\": [");
+
+    for (long long taille = 10; taille <= taille_max; taille *= 10)
+    {
+        for (size_t i = 0; i < sizeof(variantes) / sizeof(variantes[0]); i++)
+        {
+            // a fixed-size container cannot hold the larger sizes
+            if (variantes[i].capacite && taille > variantes[i].capacite)
+                continue;
+
+            for (motif_banc motif = 0; motif < NB_MOTIFS; motif++)
+            {
+                resultat_banc resultat;
+                if (executer_cas(&variantes[i], motif, taille, &resultat) == -1)
+                    echecs++;
+                rapporter(&variantes[i], motif, taille, &resultat, fichier_csv, fichier_json, premier);
+                premier = 0;
+            }
+        }
+    }
+
+    if (fichier_csv)
+        fclose(fichier_csv);
+    if (fichier_json)
+    {
+        fprintf(fichier_json, "\n  ]\n}\n");
+        fclose(fichier_json);
+    }
+
+    if (echecs)
+        printf("%d case(s) failed\n", echecs);
+    return echecs ? -1 : 0;
+}
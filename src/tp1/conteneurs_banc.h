@@ -0,0 +1,71 @@
+/**
+ * @file conteneurs_banc.h
+ * @brief Benchmark suite of the stacks and queues of int.
+ *
+ * Every variant is measured at sizes from 10 to BANC_TAILLE_MAX by powers of ten, with three patterns:
+ * pushes from empty, pops down to empty, and pushes and pops drawn at random around half the size. Each case
+ * runs in a child process, so that its peak resident set size is its own, and sends back its throughput and
+ * the median and 99th percentile of the latency of an operation through a pipe. The results are printed as a
+ * table and may be written as CSV or JSON, to be tracked over time.
+ */
+
+#ifndef R305_CONTENEURS_BANC_H
+#define R305_CONTENEURS_BANC_H
+
+#include "queue_and_stack_operations.h"
+
+/// Largest size measured by default
+#define BANC_TAILLE_MAX 100000000LL
+
+/// Smallest number of operations of a case, the small sizes being repeated to reach it
+#define OPERATIONS_MIN_BANC 1000000LL
+
+/// Largest number of operations whose latency is sampled in a case
+#define ECHANTILLONS_BANC (1 << 14)
+
+/// Capacity of the fixed-size stack and queue measured, larger than the one of queue_and_stack_operations.h
+#define CAPACITE_FIXE_BANC 1000000
+
+/// The patterns of operations
+typedef enum
+{
+    MOTIF_AJOUTS,    ///< push-heavy: pushes from empty up to the size
+    MOTIF_RETRAITS,  ///< pop-heavy: pops from the size down to empty
+    MOTIF_MIXTE,     ///< mixed: as many pushes and pops, drawn at random, from half the size
+    NB_MOTIFS
+} motif_banc;
+
+/// A container measured, behind functions on an opaque pointer
+typedef struct
+{
+    const char *nom;
+    int pile;                 ///< 1 for a stack, 0 for a queue
+    long long capacite;       ///< largest number of elements, 0 if unbounded
+    void *(*creer)(long long taille);
+    int (*ajouter)(void *conteneur, element_t element);
+    int (*retirer)(void *conteneur, element_t *p_element);
+    void (*detruire)(void *conteneur);
+} variante_banc;
+
+/// The measures of a case, sent by the child process
+typedef struct
+{
+    int erreur;               ///< 0, or -1 if memory allocation failed or an element came out wrong
+    long long operations;     ///< number of operations timed
+    double duree;             ///< time taken by the operations, in seconds
+    double p50;               ///< median latency of an operation, in nanoseconds
+    double p99;               ///< 99th percentile of the latency of an operation, in nanoseconds
+    long rss_max;             ///< peak resident set size of the child, in KiB
+} resultat_banc;
+
+/**
+ * @brief Runs the benchmark suite.
+ *
+ * @param taille_max The largest size measured.
+ * @param csv Path of the CSV file to write, or NULL.
+ * @param json Path of the JSON file to write, or NULL.
+ * @return 0 if every case succeeded, -1 otherwise.
+ */
+int banc_conteneurs(long long taille_max, const char *csv, const char *json);
+
+#endif //R305_CONTENEURS_BANC_H
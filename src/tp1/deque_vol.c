@@ -0,0 +1,208 @@
+/**
+ * @file deque_vol.c
+ * @brief Lock-free work-stealing deque (Chase and Lev).
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "deque_vol.h"
+
+/**
+ * @brief Allocates an array of a deque.
+ *
+ * @return The array, or NULL if memory allocation failed.
+ */
+static tableau_vol_t *allouer_tableau(long long taille, tableau_vol_t *ancien)
+{
+    tableau_vol_t *tableau = malloc(sizeof(tableau_vol_t) + (size_t) taille * sizeof(_Atomic(void *)));
+    if (!tableau)
+        return NULL;
+
+    tableau->taille = taille;
+    tableau->ancien = ancien;
+    return tableau;
+}
+
+/**
+ * @brief Initialises an empty deque.
+ *
+ * @return 0 on success, -1 if memory allocation failed.
+ */
+int deque_vol_initialiser(deque_vol_t *deque)
+{
+    tableau_vol_t *tableau = allouer_tableau(TAILLE_DEQUE_VOL, NULL);
+    if (!tableau)
+        return -1;
+
+    atomic_init(&deque->base, 0);
+    atomic_init(&deque->sommet, 0);
+    atomic_init(&deque->tableau, tableau);
+    return 0;
+}
+
+/**
+ * @brief Returns the number of elements of the deque. The answer may be stale as soon as it is returned.
+ */
+long long deque_vol_taille(deque_vol_t *deque)
+{
+    long long base = atomic_load_explicit(&deque->base, memory_order_acquire);
+    long long sommet = atomic_load_explicit(&deque->sommet, memory_order_acquire);
+    return sommet > base ? sommet - base : 0;
+}
+
+/**
+ * @brief Pushes an element on top of the deque. Called by the owner only.
+ *
+ * @return 0 on success, -1 if the array had to grow and memory allocation failed.
+ */
+int deque_vol_empiler(deque_vol_t *deque, void *element)
+{
+    long long sommet = atomic_load_explicit(&deque->sommet, memory_order_relaxed);
+    long long base = atomic_load_explicit(&deque->base, memory_order_acquire);
+    tableau_vol_t *tableau = atomic_load_explicit(&deque->tableau, memory_order_relaxed);
+
+    if (sommet - base > tableau->taille - 1)
+    {
+        // the elements keep their positions, only the slots they map to change
+        if (tableau->taille > INT64_MAX / 2)
+            return -1;
+        tableau_vol_t *nouveau = allouer_tableau(tableau->taille * 2, tableau);
+        if (!nouveau)
+            return -1;
+        for (long long i = base; i < sommet; i++)
+        {
+            void *x = atomic_load_explicit(&tableau->cases[i & (tableau->taille - 1)], memory_order_relaxed);
+            atomic_store_explicit(&nouveau->cases[i & (nouveau->taille - 1)], x, memory_order_relaxed);
+        }
+        atomic_store_explicit(&deque->tableau, nouveau, memory_order_release);
+        tableau = nouveau;
+    }
+
+    atomic_store_explicit(&tableau->cases[sommet & (tableau->taille - 1)], element, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->sommet, sommet + 1, memory_order_relaxed);
+    return 0;
+}
+
+/**
+ * @brief Pops the newest element of the deque. Called by the owner only.
+ *
+ * The top is moved down before the base is read, the fence ordering the two: a thief reading the base
+ * afterwards sees the element gone, and if the base turns out to be past the new top, the element was the
+ * last one and the owner races the thieves for it on the base.
+ *
+ * @return 0 if an element was popped into p_element, -1 if the deque is empty or a thief took the last element.
+ */
+int deque_vol_depiler(deque_vol_t *deque, void **p_element)
+{
+    long long sommet = atomic_load_explicit(&deque->sommet, memory_order_relaxed) - 1;
+    tableau_vol_t *tableau = atomic_load_explicit(&deque->tableau, memory_order_relaxed);
+    atomic_store_explicit(&deque->sommet, sommet, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long base = atomic_load_explicit(&deque->base, memory_order_relaxed);
+
+    if (base > sommet)
+    {
+        // empty, the top is put back
+        atomic_store_explicit(&deque->sommet, sommet + 1, memory_order_relaxed);
+        return -1;
+    }
+
+    *p_element = atomic_load_explicit(&tableau->cases[sommet & (tableau->taille - 1)], memory_order_relaxed);
+    if (base < sommet)
+        return 0;
+
+    // the last element: whoever moves the base first gets it, and the deque is empty either way
+    int gagne = atomic_compare_exchange_strong_explicit(&deque->base, &base, base + 1, memory_order_seq_cst,
+                                                        memory_order_relaxed);
+    atomic_store_explicit(&deque->sommet, sommet + 1, memory_order_relaxed);
+    return gagne ? 0 : -1;
+}
+
+/**
+ * @brief Steals the oldest element of the deque. Called by any thread but the owner.
+ *
+ * @return 0 if an element was stolen into p_element, -1 if the deque is empty or another thread took the
+ *         element first.
+ */
+int deque_vol_voler(deque_vol_t *deque, void **p_element)
+{
+    long long base = atomic_load_explicit(&deque->base, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long sommet = atomic_load_explicit(&deque->sommet, memory_order_acquire);
+
+    if (base >= sommet)
+        return -1;
+
+    // consume is promoted to acquire by the compilers, which is what it is spelled here
+    tableau_vol_t *tableau = atomic_load_explicit(&deque->tableau, memory_order_acquire);
+    void *x = atomic_load_explicit(&tableau->cases[base & (tableau->taille - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->base, &base, base + 1, memory_order_seq_cst,
+                                                 memory_order_relaxed))
+        return -1;
+
+    *p_element = x;
+    return 0;
+}
+
+/**
+ * @brief Frees the arrays of a deque. No thread may use the deque any more.
+ */
+void deque_vol_detruire(deque_vol_t *deque)
+{
+    tableau_vol_t *tableau = atomic_load_explicit(&deque->tableau, memory_order_relaxed);
+    while (tableau)
+    {
+        tableau_vol_t *ancien = tableau->ancien;
+        free(tableau);
+        tableau = ancien;
+    }
+    atomic_store_explicit(&deque->tableau, NULL, memory_order_relaxed);
+}
+
+/**
+ * @brief Tests the deque from a single thread: order at both ends and growth of the array.
+ */
+void test_deque_vol(void)
+{
+    deque_vol_t deque;
+    int valeurs[3 * TAILLE_DEQUE_VOL];
+    void *x;
+
+    assert(deque_vol_initialiser(&deque) == 0);
+
+    // A deque initialized must be empty
+    assert(deque_vol_taille(&deque) == 0);
+    assert(deque_vol_depiler(&deque, &x) == -1);
+    assert(deque_vol_voler(&deque, &x) == -1);
+
+    // stealing a few elements first makes the elements wrap around the end of the array when it grows
+    for (int i = 0; i < 3 * TAILLE_DEQUE_VOL; i++)
+    {
+        assert(deque_vol_empiler(&deque, &valeurs[i]) == 0);
+        if (i % 8 == 0)
+        {
+            assert(deque_vol_voler(&deque, &x) == 0);
+            assert(x == &valeurs[i / 8]);
+        }
+    }
+    assert(deque_vol_taille(&deque) == 3 * TAILLE_DEQUE_VOL - 3 * TAILLE_DEQUE_VOL / 8);
+
+    // the owner takes the newest elements, the thieves the oldest
+    int base = 3 * TAILLE_DEQUE_VOL / 8, sommet = 3 * TAILLE_DEQUE_VOL;
+    while (base < sommet)
+    {
+        assert(deque_vol_depiler(&deque, &x) == 0);
+        assert(x == &valeurs[--sommet]);
+        if (base < sommet)
+        {
+            assert(deque_vol_voler(&deque, &x) == 0);
+            assert(x == &valeurs[base++]);
+        }
+    }
+    assert(deque_vol_depiler(&deque, &x) == -1);
+    assert(deque_vol_voler(&deque, &x) == -1);
+
+    deque_vol_detruire(&deque);
+}
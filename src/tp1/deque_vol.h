@@ -0,0 +1,83 @@
+/**
+ * @file deque_vol.h
+ * @brief Lock-free work-stealing deque (Chase and Lev).
+ *
+ * The deque belongs to one thread, which uses it as a stack: it pushes and pops at the top. Any other thread
+ * may steal the element at the base, the oldest one. The owner only contends with the thieves for the last
+ * element, so that as long as the deque holds a few elements, pushing and popping cost no more than a
+ * store and, for popping, a fence; the thieves race each other with a compare and swap on the base.
+ *
+ * The elements sit in a circular array that the owner doubles when it is full. A thief may still be reading
+ * the previous array, which is therefore only freed with the deque. The positions are signed 64-bit counters
+ * that only grow, so that the owner can move the top below the base for a moment while popping.
+ *
+ * The memory orders are those of the C11 version of Lê, Pop, Cohen and Zappa Nardelli (PPoPP 2013).
+ */
+
+#ifndef R305_DEQUE_VOL_H
+#define R305_DEQUE_VOL_H
+
+#include <stdatomic.h>
+#include "file_spsc.h"
+
+/// Initial number of elements of the array of a deque
+#define TAILLE_DEQUE_VOL 64
+
+/// A circular array of a deque, and the array it replaced
+typedef struct tableau_vol
+{
+    long long taille;             ///< a power of two
+    struct tableau_vol *ancien;   ///< the previous, smaller array, kept for the thieves still reading it
+    _Atomic(void *) cases[];
+} tableau_vol_t;
+
+/// A work-stealing deque of pointers
+typedef struct
+{
+    _Alignas(TAILLE_LIGNE_CACHE) atomic_llong base;     ///< position of the oldest element, moved by the thieves
+    _Alignas(TAILLE_LIGNE_CACHE) atomic_llong sommet;   ///< position after the newest element, moved by the owner
+    _Atomic(tableau_vol_t *) tableau;
+} deque_vol_t;
+
+/**
+ * @brief Initialises an empty deque.
+ *
+ * @return 0 on success, -1 if memory allocation failed.
+ */
+int deque_vol_initialiser(deque_vol_t *deque);
+
+/**
+ * @brief Returns the number of elements of the deque. The answer may be stale as soon as it is returned.
+ */
+long long deque_vol_taille(deque_vol_t *deque);
+
+/**
+ * @brief Pushes an element on top of the deque. Called by the owner only.
+ *
+ * @return 0 on success, -1 if the array had to grow and memory allocation failed.
+ */
+int deque_vol_empiler(deque_vol_t *deque, void *element);
+
+/**
+ * @brief Pops the newest element of the deque. Called by the owner only.
+ *
+ * @return 0 if an element was popped into p_element, -1 if the deque is empty or a thief took the last element.
+ */
+int deque_vol_depiler(deque_vol_t *deque, void **p_element);
+
+/**
+ * @brief Steals the oldest element of the deque. Called by any thread but the owner.
+ *
+ * @return 0 if an element was stolen into p_element, -1 if the deque is empty or another thread took the
+ *         element first.
+ */
+int deque_vol_voler(deque_vol_t *deque, void **p_element);
+
+/**
+ * @brief Frees the arrays of a deque. No thread may use the deque any more.
+ */
+void deque_vol_detruire(deque_vol_t *deque);
+
+void test_deque_vol(void);
+
+#endif //R305_DEQUE_VOL_H
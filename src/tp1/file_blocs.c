@@ -0,0 +1,216 @@
+/**
+ * @file file_blocs.c
+ * @brief Unbounded queue made of a linked list of fixed-size chunks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "file_blocs.h"
+
+/**
+ * @brief Takes a chunk from the pool of the queue, or allocates one if the pool is empty.
+ *
+ * @return The chunk, or NULL if memory allocation failed.
+ */
+static bloc_t *prendre_bloc(file_blocs_t *file)
+{
+    bloc_t *bloc = file->libres;
+    if (bloc)
+    {
+        file->libres = bloc->suivant;
+        file->nb_libres--;
+    } else
+    {
+        // not aligned on a page: the header of each aligned block would push the next one to the following page
+        bloc = malloc(sizeof(bloc_t));
+        if (!bloc)
+            return NULL;
+    }
+    bloc->suivant = NULL;
+    return bloc;
+}
+
+/**
+ * @brief Gives a chunk back to the pool of the queue, or frees it if the pool is full.
+ */
+static void rendre_bloc(file_blocs_t *file, bloc_t *bloc)
+{
+    if (file->nb_libres >= RESERVE_BLOCS_MAX)
+    {
+        free(bloc);
+        return;
+    }
+    bloc->suivant = file->libres;
+    file->libres = bloc;
+    file->nb_libres++;
+}
+
+/**
+ * @brief Initialises an empty queue, with one chunk.
+ *
+ * @return 0 on success, -1 if memory allocation failed.
+ */
+int file_blocs_initialiser(file_blocs_t *file)
+{
+    file->libres = NULL;
+    file->nb_libres = 0;
+    file->debut = 0;
+    file->fin = 0;
+    file->nombre = 0;
+    file->tete = prendre_bloc(file);
+    file->queue = file->tete;
+    return file->tete ? 0 : -1;
+}
+
+/**
+ * @brief Returns 1 if the queue is empty, 0 otherwise.
+ */
+int file_blocs_est_vide(const file_blocs_t *file)
+{
+    return file->nombre == 0 ? 1 : 0;
+}
+
+/**
+ * @brief Enqueues an element.
+ *
+ * @return 0 on success, -1 if a chunk was needed and memory allocation failed.
+ */
+int file_blocs_enfiler(file_blocs_t *file, element_t const element)
+{
+    if (file->fin == ELEMENTS_PAR_BLOC)
+    {
+        bloc_t *bloc = prendre_bloc(file);
+        if (!bloc)
+            return -1;
+        file->queue->suivant = bloc;
+        file->queue = bloc;
+        file->fin = 0;
+    }
+
+    file->queue->elements[file->fin++] = element;
+    file->nombre++;
+    return 0;
+}
+
+/**
+ * @brief Dequeues the oldest element.
+ *
+ * @return 0 on success, -1 if the queue is empty.
+ */
+int file_blocs_defiler(file_blocs_t *file, element_t *p_element)
+{
+    if (file_blocs_est_vide(file))
+        return -1;
+
+    *p_element = file->tete->elements[file->debut++];
+    file->nombre--;
+
+    if (file->nombre == 0)
+    {
+        // the queue keeps a single chunk, filled again from its start
+        file->debut = 0;
+        file->fin = 0;
+    } else if (file->debut == ELEMENTS_PAR_BLOC)
+    {
+        bloc_t *vide = file->tete;
+        file->tete = vide->suivant;
+        file->debut = 0;
+        rendre_bloc(file, vide);
+    }
+    return 0;
+}
+
+/**
+ * @brief Frees the chunks of the queue and of its pool.
+ */
+void file_blocs_detruire(file_blocs_t *file)
+{
+    bloc_t *listes[] = {file->tete, file->libres};
+
+    for (int i = 0; i < 2; i++)
+    {
+        while (listes[i])
+        {
+            bloc_t *suivant = listes[i]->suivant;
+            free(listes[i]);
+            listes[i] = suivant;
+        }
+    }
+
+    file->tete = NULL;
+    file->queue = NULL;
+    file->libres = NULL;
+    file->nb_libres = 0;
+    file->debut = 0;
+    file->fin = 0;
+    file->nombre = 0;
+}
+
+/**
+ * @brief Displays the elements of the queue, from the oldest to the newest.
+ */
+void file_blocs_afficher(const file_blocs_t *file)
+{
+    const bloc_t *bloc = file->tete;
+    size_t j = file->debut;
+
+    for (size_t i = 0; i < file->nombre; i++, j++)
+    {
+        if (j == ELEMENTS_PAR_BLOC)
+        {
+            bloc = bloc->suivant;
+            j = 0;
+        }
+        printf("| %d ", bloc->elements[j]);
+    }
+    printf("|\n");
+}
+
+/**
+ * @brief Tests the queue of chunks: order across chunks, reuse of the chunks and size of the pool.
+ */
+void test_file_blocs(void)
+{
+    file_blocs_t file;
+    element_t e;
+
+    assert(sizeof(bloc_t) <= TAILLE_BLOC - sizeof(void *));
+    assert(file_blocs_initialiser(&file) == 0);
+
+    // A file initialized must be empty
+    assert(file_blocs_est_vide(&file));
+    assert(file_blocs_defiler(&file, &e) == -1);
+
+    for (int i = 1; i <= 6; i++)
+        assert(file_blocs_enfiler(&file, i) == 0);
+    file_blocs_afficher(&file);
+    for (int i = 1; i <= 6; i++)
+    {
+        assert(file_blocs_defiler(&file, &e) == 0);
+        assert(e == i);
+    }
+    assert(file_blocs_defiler(&file, &e) == -1);
+    assert(file_blocs_est_vide(&file));
+
+    // the elements span many chunks, which go to the pool as the queue drains and are taken back from it
+    int suivant = 0, attendu = 0, n = (int) (40 * ELEMENTS_PAR_BLOC);
+    for (int tour = 0; tour < 2; tour++)
+    {
+        while (suivant < (tour + 1) * n)
+        {
+            assert(file_blocs_enfiler(&file, suivant++) == 0);
+            if (suivant % 3 == 0)
+            {
+                assert(file_blocs_defiler(&file, &e) == 0);
+                assert(e == attendu++);
+            }
+        }
+        while (file_blocs_defiler(&file, &e) == 0)
+            assert(e == attendu++);
+        assert(attendu == suivant);
+        assert(file.tete == file.queue && file.nb_libres == RESERVE_BLOCS_MAX);
+    }
+
+    file_blocs_detruire(&file);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file file_blocs.h
+ * @brief Unbounded queue made of a linked list of fixed-size chunks.
+ *
+ * The elements are stored in chunks of TAILLE_BLOC bytes, allocator header included, linked from the oldest
+ * to the newest. Enqueueing fills the newest chunk and links a new one when it is full; dequeueing empties the
+ * oldest chunk and unlinks it once it is empty. No element is ever moved, whatever the size of the queue,
+ * where file_variable_t copies its ring each time it doubles.
+ *
+ * The chunks unlinked go to a pool of free chunks kept by the queue, from which the next chunks are taken:
+ * a queue going up and down around a size does not call the allocator. The pool keeps at most
+ * RESERVE_BLOCS_MAX chunks, the others being freed, so that the memory of a queue that drained is returned.
+ */
+
+#ifndef R305_FILE_BLOCS_H
+#define R305_FILE_BLOCS_H
+
+#include <stddef.h>
+#include "queue_and_stack_operations.h"
+
+/// Size taken by a chunk on the heap in bytes, a page
+#define TAILLE_BLOC 4096
+
+/// Number of elements of a chunk, the rest of the page holding the link and the header of the allocator
+#define ELEMENTS_PAR_BLOC ((TAILLE_BLOC - 2 * sizeof(void *)) / sizeof(element_t))
+
+/// Largest number of free chunks kept by a queue
+#define RESERVE_BLOCS_MAX 16
+
+/// A chunk of a queue
+typedef struct bloc
+{
+    struct bloc *suivant;                   ///< the next newer chunk, or the next free chunk of the pool
+    element_t elements[ELEMENTS_PAR_BLOC];
+} bloc_t;
+
+/// A queue of chunks
+typedef struct
+{
+    bloc_t *tete;       ///< the oldest chunk, holding the next element to dequeue
+    bloc_t *queue;      ///< the newest chunk, holding the last element enqueued
+    size_t debut;       ///< index of the next element to dequeue in the oldest chunk
+    size_t fin;         ///< index of the next free slot in the newest chunk
+    size_t nombre;      ///< number of elements of the queue
+    bloc_t *libres;     ///< the pool of free chunks
+    int nb_libres;      ///< number of chunks of the pool
+} file_blocs_t;
+
+/**
+ * @brief Initialises an empty queue, with one chunk.
+ *
+ * @return 0 on success, -1 if memory allocation failed.
+ */
+int file_blocs_initialiser(file_blocs_t *file);
+
+/**
+ * @brief Returns 1 if the queue is empty, 0 otherwise.
+ */
+int file_blocs_est_vide(const file_blocs_t *file);
+
+/**
+ * @brief Enqueues an element.
+ *
+ * @return 0 on success, -1 if a chunk was needed and memory allocation failed.
+ */
+int file_blocs_enfiler(file_blocs_t *file, element_t element);
+
+/**
+ * @brief Dequeues the oldest element.
+ *
+ * @return 0 on success, -1 if the queue is empty.
+ */
+int file_blocs_defiler(file_blocs_t *file, element_t *p_element);
+
+/**
+ * @brief Frees the chunks of the queue and of its pool.
+ */
+void file_blocs_detruire(file_blocs_t *file);
+
+/**
+ * @brief Displays the elements of the queue, from the oldest to the newest.
+ */
+void file_blocs_afficher(const file_blocs_t *file);
+
+void test_file_blocs(void);
+
+#endif //R305_FILE_BLOCS_H
@@ -0,0 +1,444 @@
+/**
+ * @file file_mpmc.c
+ * @brief Bounded queue shared by any number of producer and consumer threads.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <time.h>
+#include "file_mpmc.h"
+
+/**
+ * @brief Initialises an empty, open queue.
+ *
+ * @param file The queue.
+ * @param capacite The least number of elements the queue must hold, rounded up to a power of two.
+ * @return 0 on success, -1 if the capacity is too large or memory allocation failed.
+ */
+int file_mpmc_initialiser(file_mpmc_t *file, size_t capacite)
+{
+    size_t taille = 2;
+    while (taille < capacite)
+    {
+        if (taille > SIZE_MAX / 2 / sizeof(case_mpmc))
+            return -1;
+        taille *= 2;
+    }
+
+    file->cases = malloc(taille * sizeof(case_mpmc));
+    if (!file->cases)
+        return -1;
+
+    for (size_t i = 0; i < taille; i++)
+        atomic_init(&file->cases[i].sequence, i);
+    file->masque = taille - 1;
+    atomic_init(&file->queue, 0);
+    atomic_init(&file->tete, 0);
+    atomic_init(&file->fermee, 0);
+    atomic_init(&file->consommateurs_endormis, 0);
+    atomic_init(&file->producteurs_endormis, 0);
+    pthread_mutex_init(&file->verrou, NULL);
+    pthread_cond_init(&file->non_vide, NULL);
+    pthread_cond_init(&file->non_pleine, NULL);
+    return 0;
+}
+
+/**
+ * @brief Claims the slot at the tail and fills it, without waking anyone.
+ *
+ * @return 0 if the element was added, -1 if the queue is full.
+ */
+static int deposer(file_mpmc_t *file, element_t const element)
+{
+    size_t position = atomic_load_explicit(&file->queue, memory_order_relaxed);
+    case_mpmc *slot;
+
+    while (1)
+    {
+        slot = &file->cases[position & file->masque];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t ecart = (intptr_t) sequence - (intptr_t) position;
+
+        if (ecart == 0)
+        {
+            // on failure the compare and swap reloads the position claimed by another producer
+            if (atomic_compare_exchange_weak_explicit(&file->queue, &position, position + 1, memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (ecart < 0)
+        {
+            // the slot still holds the element of the previous turn
+            return -1;
+        } else
+        {
+            position = atomic_load_explicit(&file->queue, memory_order_relaxed);
+        }
+    }
+
+    slot->element = element;
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+    return 0;
+}
+
+/**
+ * @brief Claims the slot at the head and empties it, without waking anyone.
+ *
+ * @return 0 if an element was removed, -1 if the queue is empty.
+ */
+static int retirer(file_mpmc_t *file, element_t *p_element)
+{
+    size_t position = atomic_load_explicit(&file->tete, memory_order_relaxed);
+    case_mpmc *slot;
+
+    while (1)
+    {
+        slot = &file->cases[position & file->masque];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t ecart = (intptr_t) sequence - (intptr_t) (position + 1);
+
+        if (ecart == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&file->tete, &position, position + 1, memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (ecart < 0)
+        {
+            // the slot has not been filled yet on this turn
+            return -1;
+        } else
+        {
+            position = atomic_load_explicit(&file->tete, memory_order_relaxed);
+        }
+    }
+
+    *p_element = slot->element;
+    atomic_store_explicit(&slot->sequence, position + file->masque + 1, memory_order_release);
+    return 0;
+}
+
+/**
+ * @brief Wakes one thread sleeping on a condition, if any.
+ *
+ * The fence orders the store publishing the slot before the load of the number of sleepers. A sleeper
+ * announces itself, then retries under the lock before waiting: either it sees the slot, or this load
+ * sees it and the signal is sent under the lock, after the sleeper has started waiting.
+ */
+static void reveiller(file_mpmc_t *file, atomic_int *endormis, pthread_cond_t *condition)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(endormis, memory_order_relaxed) > 0)
+    {
+        pthread_mutex_lock(&file->verrou);
+        pthread_cond_signal(condition);
+        pthread_mutex_unlock(&file->verrou);
+    }
+}
+
+/**
+ * @brief Tells whether the queue is empty. The answer may be stale as soon as it is returned.
+ *
+ * @return 1 if the queue is empty, 0 otherwise.
+ */
+int file_mpmc_est_vide(file_mpmc_t *file)
+{
+    size_t position = atomic_load_explicit(&file->tete, memory_order_acquire);
+    size_t sequence = atomic_load_explicit(&file->cases[position & file->masque].sequence, memory_order_acquire);
+    return sequence != position + 1 ? 1 : 0;
+}
+
+/**
+ * @brief Adds an element at the tail of the queue if there is room.
+ *
+ * @return 0 if the element was added, -1 if the queue is full or closed.
+ */
+int file_mpmc_essayer_enfiler(file_mpmc_t *file, element_t const element)
+{
+    if (atomic_load_explicit(&file->fermee, memory_order_acquire) || deposer(file, element) == -1)
+        return -1;
+
+    reveiller(file, &file->consommateurs_endormis, &file->non_vide);
+    return 0;
+}
+
+/**
+ * @brief Removes the element at the head of the queue if there is one.
+ *
+ * @return 0 if an element was removed into p_element, -1 if the queue is empty.
+ */
+int file_mpmc_essayer_defiler(file_mpmc_t *file, element_t *p_element)
+{
+    if (retirer(file, p_element) == -1)
+        return -1;
+
+    reveiller(file, &file->producteurs_endormis, &file->non_pleine);
+    return 0;
+}
+
+/**
+ * @brief Adds an element at the tail of the queue, waiting for room.
+ *
+ * @return 0 if the element was added, -1 if the queue is or gets closed.
+ */
+int file_mpmc_enfiler(file_mpmc_t *file, element_t const element)
+{
+    for (int essai = 0; essai < ESSAIS_MPMC; essai++)
+    {
+        if (atomic_load_explicit(&file->fermee, memory_order_acquire))
+            return -1;
+        if (file_mpmc_essayer_enfiler(file, element) == 0)
+            return 0;
+    }
+
+    int resultat;
+    pthread_mutex_lock(&file->verrou);
+    atomic_fetch_add(&file->producteurs_endormis, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    while ((resultat = atomic_load(&file->fermee) ? -1 : deposer(file, element)) == -1 && !atomic_load(&file->fermee))
+        pthread_cond_wait(&file->non_pleine, &file->verrou);
+    atomic_fetch_sub(&file->producteurs_endormis, 1);
+    pthread_mutex_unlock(&file->verrou);
+
+    if (resultat == 0)
+        reveiller(file, &file->consommateurs_endormis, &file->non_vide);
+    return resultat;
+}
+
+/**
+ * @brief Removes the element at the head of the queue, waiting for one.
+ *
+ * The elements added before the queue was closed are still handed out.
+ *
+ * @return 0 if an element was removed into p_element, -1 if the queue is closed and empty.
+ */
+int file_mpmc_defiler(file_mpmc_t *file, element_t *p_element)
+{
+    for (int essai = 0; essai < ESSAIS_MPMC; essai++)
+    {
+        if (file_mpmc_essayer_defiler(file, p_element) == 0)
+            return 0;
+    }
+
+    int resultat;
+    pthread_mutex_lock(&file->verrou);
+    atomic_fetch_add(&file->consommateurs_endormis, 1);
+    atomic_thread_fence(memory_order_seq_cst);
+    while ((resultat = retirer(file, p_element)) == -1 && !atomic_load(&file->fermee))
+        pthread_cond_wait(&file->non_vide, &file->verrou);
+    atomic_fetch_sub(&file->consommateurs_endormis, 1);
+    pthread_mutex_unlock(&file->verrou);
+
+    if (resultat == 0)
+        reveiller(file, &file->producteurs_endormis, &file->non_pleine);
+    return resultat;
+}
+
+/**
+ * @brief Closes the queue: no element can be added any more, and the threads waiting are woken up.
+ */
+void file_mpmc_fermer(file_mpmc_t *file)
+{
+    pthread_mutex_lock(&file->verrou);
+    atomic_store(&file->fermee, 1);
+    pthread_cond_broadcast(&file->non_vide);
+    pthread_cond_broadcast(&file->non_pleine);
+    pthread_mutex_unlock(&file->verrou);
+}
+
+/**
+ * @brief Frees the slots of a queue. No thread may use the queue any more.
+ */
+void file_mpmc_detruire(file_mpmc_t *file)
+{
+    pthread_cond_destroy(&file->non_pleine);
+    pthread_cond_destroy(&file->non_vide);
+    pthread_mutex_destroy(&file->verrou);
+    free(file->cases);
+    file->cases = NULL;
+    file->masque = 0;
+}
+
+/**
+ * @brief Tests the queue from a single thread, around the end of the ring and after closing it.
+ */
+void test_file_mpmc(void)
+{
+    file_mpmc_t file;
+
+    assert(file_mpmc_initialiser(&file, 3) == 0);
+
+    // A file initialized must be empty
+    assert(file_mpmc_est_vide(&file));
+
+    element_t e;
+    assert(file_mpmc_essayer_defiler(&file, &e) == -1);
+
+    for (int tour = 0; tour < 3; tour++)
+    {
+        for (int i = 0; i < 4; i++)
+            assert(file_mpmc_essayer_enfiler(&file, tour * 4 + i) == 0);
+        assert(file_mpmc_essayer_enfiler(&file, -1) == -1);
+
+        for (int i = 0; i < 4; i++)
+        {
+            assert(file_mpmc_defiler(&file, &e) == 0);
+            assert(e == tour * 4 + i);
+        }
+        assert(file_mpmc_est_vide(&file));
+    }
+
+    assert(file_mpmc_enfiler(&file, 1) == 0);
+    assert(file_mpmc_enfiler(&file, 2) == 0);
+    file_mpmc_fermer(&file);
+    assert(file_mpmc_enfiler(&file, 3) == -1);
+    assert(file_mpmc_essayer_enfiler(&file, 3) == -1);
+
+    // the elements added before closing are still handed out
+    assert(file_mpmc_defiler(&file, &e) == 0);
+    assert(e == 1);
+    assert(file_mpmc_defiler(&file, &e) == 0);
+    assert(e == 2);
+    assert(file_mpmc_defiler(&file, &e) == -1);
+
+    file_mpmc_detruire(&file);
+}
+
+/// A queue of the benchmark and the share of one of its threads
+typedef struct
+{
+    file_mpmc_t *file;             ///< the lock-free queue, NULL for the locked one
+    file_variable_t *verrouillee;  ///< the locked queue
+    pthread_mutex_t *verrou;
+    pthread_cond_t *non_vide;
+    long paires;                   ///< number of enqueue and dequeue pairs of the thread
+    long long somme;               ///< sum of the elements removed by the thread
+} participant_banc;
+
+/**
+ * @brief Returns the current time of the monotonic clock in seconds.
+ */
+static double maintenant(void)
+{
+    struct timespec temps;
+    clock_gettime(CLOCK_MONOTONIC, &temps);
+    return temps.tv_sec + temps.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Body of a thread of the benchmark: adds an element, then removes one, paires times.
+ *
+ * Each thread adds before it removes, so the blocking dequeue always ends up finding an element.
+ */
+static void *participer(void *argument)
+{
+    participant_banc *participant = argument;
+
+    for (long i = 0; i < participant->paires; i++)
+    {
+        element_t e = (element_t) (i & 0xFFFF);
+
+        if (participant->file)
+        {
+            if (file_mpmc_enfiler(participant->file, e) == -1 || file_mpmc_defiler(participant->file, &e) == -1)
+                break;
+        } else
+        {
+            pthread_mutex_lock(participant->verrou);
+            file_variable_enfiler(participant->verrouillee, e);
+            pthread_cond_signal(participant->non_vide);
+            while (file_variable_defiler(participant->verrouillee, &e) == -1)
+                pthread_cond_wait(participant->non_vide, participant->verrou);
+            pthread_mutex_unlock(participant->verrou);
+        }
+        participant->somme += e;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Runs one case of the benchmark.
+ *
+ * @return 0 if the elements removed are the elements added, -1 otherwise.
+ */
+static int executer_banc(const char *nom, int nb_threads, participant_banc *modele)
+{
+    participant_banc participants[nb_threads];
+    pthread_t threads[nb_threads];
+    long long attendue = 0, obtenue = 0;
+    int lances = 0;
+
+    double debut = maintenant();
+    for (; lances < nb_threads; lances++)
+    {
+        participants[lances] = *modele;
+        participants[lances].paires = OPERATIONS_BANC_MPMC / nb_threads;
+        if (pthread_create(&threads[lances], NULL, participer, &participants[lances]) != 0)
+            break;
+    }
+    for (int i = 0; i < lances; i++)
+    {
+        pthread_join(threads[i], NULL);
+        obtenue += participants[i].somme;
+        for (long j = 0; j < participants[i].paires; j++)
+            attendue += j & 0xFFFF;
+    }
+    double duree = maintenant() - debut;
+
+    if (lances < nb_threads)
+    {
+        printf("Error: Cannot start %d threads\n", nb_threads);
+        return -1;
+    }
+
+    long operations = 2L * (OPERATIONS_BANC_MPMC / nb_threads) * nb_threads;
+    printf("%-28s %2d threads %9.2f ms %9.2f Mops/s  %s\n", nom, nb_threads, duree * 1e3,
+           operations / 1e6 / duree, attendue == obtenue ? "ok" : "LOST ELEMENTS");
+    return attendue == obtenue ? 0 : -1;
+}
+
+/**
+ * @brief Runs OPERATIONS_BANC_MPMC enqueue and dequeue pairs on 1 to THREADS_BANC_MPMC threads, each thread
+ *        adding an element then removing one, through the queue and through a file_variable_t guarded by a
+ *        mutex, and prints the throughput of each.
+ *
+ * @return 0 on success, -1 if a thread could not be started or an element was lost.
+ */
+int banc_file_mpmc(void)
+{
+    file_mpmc_t file;
+    file_variable_t verrouillee;
+    pthread_mutex_t verrou = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t non_vide = PTHREAD_COND_INITIALIZER;
+    int resultat = 0;
+
+    if (file_mpmc_initialiser(&file, 1024) == -1)
+    {
+        printf("Error: Memory allocation failed\n");
+        return -1;
+    }
+    if (file_variable_initialiser(&verrouillee) == -1)
+    {
+        printf("Error: Memory allocation failed\n");
+        file_mpmc_detruire(&file);
+        return -1;
+    }
+
+    participant_banc sans_verrou = {&file, NULL, NULL, NULL, 0, 0};
+    participant_banc avec_verrou = {NULL, &verrouillee, &verrou, &non_vide, 0, 0};
+
+    for (int nb_threads = 1; nb_threads <= THREADS_BANC_MPMC; nb_threads *= 2)
+    {
+        if (executer_banc("file_variable_t + mutex", nb_threads, &avec_verrou) == -1)
+            resultat = -1;
+        if (executer_banc("file_mpmc_t", nb_threads, &sans_verrou) == -1)
+            resultat = -1;
+    }
+
+    pthread_cond_destroy(&non_vide);
+    pthread_mutex_destroy(&verrou);
+    file_variable_detruire(&verrouillee);
+    file_mpmc_detruire(&file);
+    return resultat;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file file_mpmc.h
+ * @brief Bounded queue shared by any number of producer and consumer threads.
+ *
+ * The slots form a ring whose capacity is a power of two, and each slot carries a sequence number telling
+ * whose turn it is (Vyukov's bounded MPMC queue). A slot whose sequence equals the position of the tail is
+ * free for the producer claiming that position; once filled its sequence becomes the position plus one, which
+ * is what the consumer claiming that position waits for; once emptied it becomes the position plus the
+ * capacity, the position of the tail on the next turn of the ring. Positions are claimed by a compare and swap
+ * on the head or the tail, so that a thread only ever contends with the threads on the same side.
+ *
+ * The try variants never wait. The blocking variants retry for a while, then sleep on a condition variable
+ * until the other side makes room or brings an element; a thread that succeeds only takes the lock when
+ * it sees someone asleep, so that the lock stays out of the way as long as the queue is neither full nor
+ * empty. Closing the queue wakes every sleeper, which is how a pool of consumers is told that no work is left.
+ */
+
+#ifndef R305_FILE_MPMC_H
+#define R305_FILE_MPMC_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "queue_and_stack_operations.h"
+#include "file_spsc.h"
+
+/// Number of failed attempts of a blocking operation before it sleeps
+#define ESSAIS_MPMC 64
+
+/// Number of enqueue and dequeue pairs of each case of the benchmark, shared among its threads
+#define OPERATIONS_BANC_MPMC (1 << 20)
+
+/// Largest number of threads of the benchmark, the counts are the powers of two up to it
+#define THREADS_BANC_MPMC 64
+
+/// A slot of the ring
+typedef struct
+{
+    atomic_size_t sequence;  ///< position of the tail if the slot is free, that position + 1 once it is filled
+    element_t element;
+} case_mpmc;
+
+/// A multi-producer, multi-consumer ring
+typedef struct
+{
+    _Alignas(TAILLE_LIGNE_CACHE) atomic_size_t queue;  ///< position of the next slot to fill
+    _Alignas(TAILLE_LIGNE_CACHE) atomic_size_t tete;   ///< position of the next slot to empty
+
+    _Alignas(TAILLE_LIGNE_CACHE) case_mpmc *cases;     ///< the slots, the array is read-only after initialisation
+    size_t masque;                                     ///< capacity - 1
+    atomic_int fermee;                                 ///< 1 once file_mpmc_fermer has been called
+
+    pthread_mutex_t verrou;                            ///< taken to sleep and to wake sleepers only
+    pthread_cond_t non_vide;                           ///< signalled when an element is added and a consumer sleeps
+    pthread_cond_t non_pleine;                         ///< signalled when an element is removed and a producer sleeps
+    atomic_int consommateurs_endormis;
+    atomic_int producteurs_endormis;
+} file_mpmc_t;
+
+/**
+ * @brief Initialises an empty, open queue.
+ *
+ * @param file The queue.
+ * @param capacite The least number of elements the queue must hold, rounded up to a power of two.
+ * @return 0 on success, -1 if the capacity is too large or memory allocation failed.
+ */
+int file_mpmc_initialiser(file_mpmc_t *file, size_t capacite);
+
+/**
+ * @brief Tells whether the queue is empty. The answer may be stale as soon as it is returned.
+ *
+ * @return 1 if the queue is empty, 0 otherwise.
+ */
+int file_mpmc_est_vide(file_mpmc_t *file);
+
+/**
+ * @brief Adds an element at the tail of the queue if there is room.
+ *
+ * @return 0 if the element was added, -1 if the queue is full or closed.
+ */
+int file_mpmc_essayer_enfiler(file_mpmc_t *file, element_t element);
+
+/**
+ * @brief Removes the element at the head of the queue if there is one.
+ *
+ * @return 0 if an element was removed into p_element, -1 if the queue is empty.
+ */
+int file_mpmc_essayer_defiler(file_mpmc_t *file, element_t *p_element);
+
+/**
+ * @brief Adds an element at the tail of the queue, waiting for room.
+ *
+ * @return 0 if the element was added, -1 if the queue is or gets closed.
+ */
+int file_mpmc_enfiler(file_mpmc_t *file, element_t element);
+
+/**
+ * @brief Removes the element at the head of the queue, waiting for one.
+ *
+ * The elements added before the queue was closed are still handed out.
+ *
+ * @return 0 if an element was removed into p_element, -1 if the queue is closed and empty.
+ */
+int file_mpmc_defiler(file_mpmc_t *file, element_t *p_element);
+
+/**
+ * @brief Closes the queue: no element can be added any more, and the threads waiting are woken up.
+ */
+void file_mpmc_fermer(file_mpmc_t *file);
+
+/**
+ * @brief Frees the slots of a queue. No thread may use the queue any more.
+ */
+void file_mpmc_detruire(file_mpmc_t *file);
+
+void test_file_mpmc(void);
+
+/**
+ * @brief Runs OPERATIONS_BANC_MPMC enqueue and dequeue pairs on 1 to THREADS_BANC_MPMC threads, each thread
+ *        adding an element then removing one, through the queue and through a file_variable_t guarded by a
+ *        mutex, and prints the throughput of each.
+ *
+ * @return 0 on success, -1 if a thread could not be started or an element was lost.
+ */
+int banc_file_mpmc(void);
+
+#endif //R305_FILE_MPMC_H
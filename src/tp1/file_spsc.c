@@ -0,0 +1,386 @@
+/**
+ * @file file_spsc.c
+ * @brief Lock-free bounded queue for one producer thread and one consumer thread.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include "file_spsc.h"
+
+/**
+ * @brief Initialises an empty ring.
+ *
+ * @param file The ring.
+ * @param capacite The least number of elements the ring must hold, rounded up to a power of two.
+ * @return 0 on success, -1 if the capacity is too large or memory allocation failed.
+ */
+int file_spsc_initialiser(file_spsc_t *file, size_t capacite)
+{
+    size_t taille = CAPACITE_SPSC_MIN;
+    while (taille < capacite)
+    {
+        if (taille > SIZE_MAX / 2 / sizeof(element_t))
+            return -1;
+        taille *= 2;
+    }
+
+    // the size is a multiple of the alignment, as aligned_alloc requires
+    file->file = aligned_alloc(TAILLE_LIGNE_CACHE, taille * sizeof(element_t));
+    if (!file->file)
+        return -1;
+
+    file->masque = taille - 1;
+    atomic_init(&file->tete, 0);
+    atomic_init(&file->queue, 0);
+    file->queue_vue = 0;
+    file->tete_vue = 0;
+    return 0;
+}
+
+/**
+ * @brief Returns the number of elements the ring can hold.
+ */
+size_t file_spsc_capacite(const file_spsc_t *file)
+{
+    return file->masque + 1;
+}
+
+/**
+ * @brief Tells whether the ring is empty, from the point of view of the consumer.
+ *
+ * @return 1 if the ring is empty, 0 otherwise.
+ */
+int file_spsc_est_vide(const file_spsc_t *file)
+{
+    return atomic_load_explicit(&file->tete, memory_order_relaxed)
+           == atomic_load_explicit(&file->queue, memory_order_acquire) ? 1 : 0;
+}
+
+/**
+ * @brief Returns the number of free slots seen by the producer, rereading the head only if the copy is not enough.
+ */
+static size_t places_libres(file_spsc_t *file, size_t queue, size_t voulues)
+{
+    size_t libres = file_spsc_capacite(file) - (queue - file->tete_vue);
+    if (libres < voulues)
+    {
+        // the acquire pairs with the release of the consumer: the slots it freed are no longer read
+        file->tete_vue = atomic_load_explicit(&file->tete, memory_order_acquire);
+        libres = file_spsc_capacite(file) - (queue - file->tete_vue);
+    }
+    return libres;
+}
+
+/**
+ * @brief Returns the number of elements seen by the consumer, rereading the tail only if the copy is not enough.
+ */
+static size_t elements_presents(file_spsc_t *file, size_t tete, size_t voulus)
+{
+    size_t presents = file->queue_vue - tete;
+    if (presents < voulus)
+    {
+        // the acquire pairs with the release of the producer: the slots it filled are visible
+        file->queue_vue = atomic_load_explicit(&file->queue, memory_order_acquire);
+        presents = file->queue_vue - tete;
+    }
+    return presents;
+}
+
+/**
+ * @brief Adds an element at the tail of the ring. Called by the producer only.
+ *
+ * @return 0 if the element was added, -1 if the ring is full.
+ */
+int file_spsc_enfiler(file_spsc_t *file, element_t const element)
+{
+    size_t queue = atomic_load_explicit(&file->queue, memory_order_relaxed);
+    if (places_libres(file, queue, 1) == 0)
+        return -1;
+
+    file->file[queue & file->masque] = element;
+    atomic_store_explicit(&file->queue, queue + 1, memory_order_release);
+    return 0;
+}
+
+/**
+ * @brief Removes the element at the head of the ring. Called by the consumer only.
+ *
+ * @return 0 if an element was removed into p_element, -1 if the ring is empty.
+ */
+int file_spsc_defiler(file_spsc_t *file, element_t *p_element)
+{
+    size_t tete = atomic_load_explicit(&file->tete, memory_order_relaxed);
+    if (elements_presents(file, tete, 1) == 0)
+        return -1;
+
+    *p_element = file->file[tete & file->masque];
+    atomic_store_explicit(&file->tete, tete + 1, memory_order_release);
+    return 0;
+}
+
+/**
+ * @brief Adds as many elements of an array as there is room for. Called by the producer only.
+ *
+ * The elements are published together by a single store.
+ *
+ * @param file The ring.
+ * @param elements The elements, in order.
+ * @param nombre The number of elements.
+ * @return The number of elements added, from 0 if the ring is full to nombre.
+ */
+size_t file_spsc_enfiler_lot(file_spsc_t *file, const element_t *elements, size_t nombre)
+{
+    size_t queue = atomic_load_explicit(&file->queue, memory_order_relaxed);
+    size_t libres = places_libres(file, queue, nombre);
+    if (nombre > libres)
+        nombre = libres;
+
+    // the free slots wrap around the end of the ring at most once
+    size_t debut = queue & file->masque;
+    size_t avant_fin = file_spsc_capacite(file) - debut;
+    size_t premiers = nombre < avant_fin ? nombre : avant_fin;
+    memcpy(file->file + debut, elements, premiers * sizeof(element_t));
+    memcpy(file->file, elements + premiers, (nombre - premiers) * sizeof(element_t));
+
+    atomic_store_explicit(&file->queue, queue + nombre, memory_order_release);
+    return nombre;
+}
+
+/**
+ * @brief Removes up to a given number of elements into an array. Called by the consumer only.
+ *
+ * @param file The ring.
+ * @param elements Receives the elements, in order.
+ * @param nombre The largest number of elements to remove.
+ * @return The number of elements removed, from 0 if the ring is empty to nombre.
+ */
+size_t file_spsc_defiler_lot(file_spsc_t *file, element_t *elements, size_t nombre)
+{
+    size_t tete = atomic_load_explicit(&file->tete, memory_order_relaxed);
+    size_t presents = elements_presents(file, tete, nombre);
+    if (nombre > presents)
+        nombre = presents;
+
+    size_t debut = tete & file->masque;
+    size_t avant_fin = file_spsc_capacite(file) - debut;
+    size_t premiers = nombre < avant_fin ? nombre : avant_fin;
+    memcpy(elements, file->file + debut, premiers * sizeof(element_t));
+    memcpy(elements + premiers, file->file, (nombre - premiers) * sizeof(element_t));
+
+    atomic_store_explicit(&file->tete, tete + nombre, memory_order_release);
+    return nombre;
+}
+
+/**
+ * @brief Frees the slots of a ring. No thread may use the ring any more.
+ */
+void file_spsc_detruire(file_spsc_t *file)
+{
+    free(file->file);
+    file->file = NULL;
+    file->masque = 0;
+}
+
+/**
+ * @brief Tests the ring from a single thread, wrapping the indices around the end of the slots.
+ */
+void test_file_spsc(void)
+{
+    file_spsc_t file;
+
+    assert(file_spsc_initialiser(&file, 20) == 0);
+    assert(file_spsc_capacite(&file) == 32);
+
+    // A file initialized must be empty
+    assert(file_spsc_est_vide(&file));
+
+    element_t e;
+    assert(file_spsc_defiler(&file, &e) == -1);
+
+    for (int i = 0; i < 32; i++)
+        assert(file_spsc_enfiler(&file, i) == 0);
+    assert(file_spsc_enfiler(&file, 32) == -1);
+
+    for (int i = 0; i < 20; i++)
+    {
+        assert(file_spsc_defiler(&file, &e) == 0);
+        assert(e == i);
+    }
+
+    // 12 elements left, 20 free slots of which 12 before the end of the ring
+    element_t lot[40];
+    for (int i = 0; i < 40; i++)
+        lot[i] = 32 + i;
+    assert(file_spsc_enfiler_lot(&file, lot, 40) == 20);
+    assert(file_spsc_enfiler_lot(&file, lot, 40) == 0);
+
+    element_t sortis[40];
+    assert(file_spsc_defiler_lot(&file, sortis, 40) == 32);
+    for (int i = 0; i < 32; i++)
+        assert(sortis[i] == 20 + i);
+    assert(file_spsc_defiler_lot(&file, sortis, 40) == 0);
+
+    assert(file_spsc_est_vide(&file));
+
+    file_spsc_detruire(&file);
+}
+
+/// Arguments of the producer thread of the benchmark
+typedef struct
+{
+    file_spsc_t *anneau;          ///< the ring, NULL for the locked queue
+    int lot;                      ///< 1 to hand the elements in bulk
+    file_variable_t *file;        ///< the locked queue
+    pthread_mutex_t *verrou;
+    size_t capacite;              ///< bound of the locked queue, as for the ring
+} producteur_banc;
+
+/**
+ * @brief Returns the current time of the monotonic clock in seconds.
+ */
+static double maintenant(void)
+{
+    struct timespec temps;
+    clock_gettime(CLOCK_MONOTONIC, &temps);
+    return temps.tv_sec + temps.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Produces the elements 0 to ELEMENTS_BANC_SPSC - 1 in order.
+ *
+ * A full queue makes the thread yield, so that the benchmark also makes progress on a single processor.
+ */
+static void *produire(void *argument)
+{
+    producteur_banc *producteur = argument;
+    element_t lot[LOT_BANC_SPSC];
+
+    for (element_t suivant = 0; suivant < ELEMENTS_BANC_SPSC;)
+    {
+        size_t ajoutes;
+
+        if (producteur->anneau && producteur->lot)
+        {
+            size_t nombre = 0;
+            for (; nombre < LOT_BANC_SPSC && suivant + (element_t) nombre < ELEMENTS_BANC_SPSC; nombre++)
+                lot[nombre] = suivant + (element_t) nombre;
+            ajoutes = file_spsc_enfiler_lot(producteur->anneau, lot, nombre);
+        } else if (producteur->anneau)
+        {
+            ajoutes = file_spsc_enfiler(producteur->anneau, suivant) == 0;
+        } else
+        {
+            pthread_mutex_lock(producteur->verrou);
+            file_variable_t *file = producteur->file;
+            ajoutes = (size_t) file->nombre < producteur->capacite && file_variable_enfiler(file, suivant) == 0;
+            pthread_mutex_unlock(producteur->verrou);
+        }
+
+        if (ajoutes == 0)
+            sched_yield();
+        suivant += (element_t) ajoutes;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Runs one case of the benchmark, the calling thread being the consumer.
+ *
+ * @return 0 if every element came out in order, -1 otherwise.
+ */
+static int executer_banc(const char *nom, producteur_banc *producteur)
+{
+    pthread_t thread;
+    element_t lot[LOT_BANC_SPSC];
+    int resultat = 0;
+
+    double debut = maintenant();
+    if (pthread_create(&thread, NULL, produire, producteur) != 0)
+    {
+        printf("Error: Cannot start the producer thread\n");
+        return -1;
+    }
+
+    for (element_t attendu = 0; attendu < ELEMENTS_BANC_SPSC;)
+    {
+        size_t retires;
+
+        if (producteur->anneau && producteur->lot)
+        {
+            retires = file_spsc_defiler_lot(producteur->anneau, lot, LOT_BANC_SPSC);
+        } else if (producteur->anneau)
+        {
+            retires = file_spsc_defiler(producteur->anneau, &lot[0]) == 0;
+        } else
+        {
+            pthread_mutex_lock(producteur->verrou);
+            retires = file_variable_defiler(producteur->file, &lot[0]) == 0;
+            pthread_mutex_unlock(producteur->verrou);
+        }
+
+        if (retires == 0)
+            sched_yield();
+        for (size_t i = 0; i < retires; i++, attendu++)
+        {
+            if (lot[i] != attendu)
+                resultat = -1;
+        }
+    }
+
+    pthread_join(thread, NULL);
+    double duree = maintenant() - debut;
+
+    printf("%-28s %9.2f ms %9.2f Mops/s  %s\n", nom, duree * 1e3, ELEMENTS_BANC_SPSC / 1e6 / duree,
+           resultat == 0 ? "ok" : "OUT OF ORDER");
+    return resultat;
+}
+
+/**
+ * @brief Hands ELEMENTS_BANC_SPSC elements from a producer thread to a consumer thread through the ring,
+ *        element by element and in bulk, and through a file_variable_t guarded by a mutex, and prints the
+ *        throughput of each.
+ *
+ * @return 0 on success, -1 if a thread could not be started or an element was lost.
+ */
+int banc_file_spsc(void)
+{
+    file_spsc_t anneau;
+    file_variable_t file;
+    pthread_mutex_t verrou = PTHREAD_MUTEX_INITIALIZER;
+    int resultat = 0;
+
+    if (file_spsc_initialiser(&anneau, 1024) == -1)
+    {
+        printf("Error: Memory allocation failed\n");
+        return -1;
+    }
+    if (file_variable_initialiser(&file) == -1)
+    {
+        printf("Error: Memory allocation failed\n");
+        file_spsc_detruire(&anneau);
+        return -1;
+    }
+
+    producteur_banc verrouille = {NULL, 0, &file, &verrou, file_spsc_capacite(&anneau)};
+    producteur_banc unitaire = {&anneau, 0, NULL, NULL, 0};
+    producteur_banc groupe = {&anneau, 1, NULL, NULL, 0};
+
+    if (executer_banc("file_variable_t + mutex", &verrouille) == -1)
+        resultat = -1;
+    if (executer_banc("file_spsc_t", &unitaire) == -1)
+        resultat = -1;
+    if (executer_banc("file_spsc_t, bulk", &groupe) == -1)
+        resultat = -1;
+
+    pthread_mutex_destroy(&verrou);
+    file_variable_detruire(&file);
+    file_spsc_detruire(&anneau);
+    return resultat;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file file_spsc.h
+ * @brief Lock-free bounded queue for one producer thread and one consumer thread.
+ *
+ * The elements live in a ring whose capacity is a power of two, so that an index is reduced to a slot with a
+ * mask. The producer only writes the tail and the consumer only writes the head, each with a release store
+ * that publishes the slots it filled or freed; no lock and no read-modify-write instruction is needed. Both
+ * indices only grow and wrap around SIZE_MAX, their difference always being the number of elements.
+ *
+ * The two indices sit on separate cache lines, each next to the copy of the other index that its owner keeps:
+ * the producer rereads the head only when the ring looks full, the consumer rereads the tail only when it
+ * looks empty, so that in steady state the two threads do not share any cache line but the slots themselves.
+ */
+
+#ifndef R305_FILE_SPSC_H
+#define R305_FILE_SPSC_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include "queue_and_stack_operations.h"
+
+/// Size of a cache line in bytes, the alignment of the fields written by different threads
+#define TAILLE_LIGNE_CACHE 64
+
+/// Smallest capacity of a ring, its slots fill at least a cache line
+#define CAPACITE_SPSC_MIN (TAILLE_LIGNE_CACHE / sizeof(element_t))
+
+/// Number of elements handed over by the benchmark
+#define ELEMENTS_BANC_SPSC (1 << 22)
+
+/// Number of elements moved at once by the bulk runs of the benchmark
+#define LOT_BANC_SPSC 64
+
+/// A single-producer, single-consumer ring
+typedef struct
+{
+    _Alignas(TAILLE_LIGNE_CACHE) atomic_size_t tete;  ///< index of the next element to dequeue, written by the consumer
+    size_t queue_vue;                                 ///< last tail read by the consumer
+
+    _Alignas(TAILLE_LIGNE_CACHE) atomic_size_t queue; ///< index of the next free slot, written by the producer
+    size_t tete_vue;                                  ///< last head read by the producer
+
+    _Alignas(TAILLE_LIGNE_CACHE) element_t *file;     ///< the slots, read-only after initialisation
+    size_t masque;                                    ///< capacity - 1
+} file_spsc_t;
+
+/**
+ * @brief Initialises an empty ring.
+ *
+ * @param file The ring.
+ * @param capacite The least number of elements the ring must hold, rounded up to a power of two.
+ * @return 0 on success, -1 if the capacity is too large or memory allocation failed.
+ */
+int file_spsc_initialiser(file_spsc_t *file, size_t capacite);
+
+/**
+ * @brief Returns the number of elements the ring can hold.
+ */
+size_t file_spsc_capacite(const file_spsc_t *file);
+
+/**
+ * @brief Tells whether the ring is empty, from the point of view of the consumer.
+ *
+ * @return 1 if the ring is empty, 0 otherwise.
+ */
+int file_spsc_est_vide(const file_spsc_t *file);
+
+/**
+ * @brief Adds an element at the tail of the ring. Called by the producer only.
+ *
+ * @return 0 if the element was added, -1 if the ring is full.
+ */
+int file_spsc_enfiler(file_spsc_t *file, element_t element);
+
+/**
+ * @brief Removes the element at the head of the ring. Called by the consumer only.
+ *
+ * @return 0 if an element was removed into p_element, -1 if the ring is empty.
+ */
+int file_spsc_defiler(file_spsc_t *file, element_t *p_element);
+
+/**
+ * @brief Adds as many elements of an array as there is room for. Called by the producer only.
+ *
+ * The elements are published together by a single store.
+ *
+ * @param file The ring.
+ * @param elements The elements, in order.
+ * @param nombre The number of elements.
+ * @return The number of elements added, from 0 if the ring is full to nombre.
+ */
+size_t file_spsc_enfiler_lot(file_spsc_t *file, const element_t *elements, size_t nombre);
+
+/**
+ * @brief Removes up to a given number of elements into an array. Called by the consumer only.
+ *
+ * @param file The ring.
+ * @param elements Receives the elements, in order.
+ * @param nombre The largest number of elements to remove.
+ * @return The number of elements removed, from 0 if the ring is empty to nombre.
+ */
+size_t file_spsc_defiler_lot(file_spsc_t *file, element_t *elements, size_t nombre);
+
+/**
+ * @brief Frees the slots of a ring. No thread may use the ring any more.
+ */
+void file_spsc_detruire(file_spsc_t *file);
+
+void test_file_spsc(void);
+
+/**
+ * @brief Hands ELEMENTS_BANC_SPSC elements from a producer thread to a consumer thread through the ring,
+ *        element by element and in bulk, and through a file_variable_t guarded by a mutex, and prints the
+ *        throughput of each.
+ *
+ * @return 0 on success, -1 if a thread could not be started or an element was lost.
+ */
+int banc_file_spsc(void);
+
+#endif //R305_FILE_SPSC_H
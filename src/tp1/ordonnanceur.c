@@ -0,0 +1,362 @@
+/**
+ * @file ordonnanceur.c
+ * @brief Work-stealing scheduler of tasks on a pool of threads.
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+#include <sched.h>
+#include <unistd.h>
+#include "ordonnanceur.h"
+
+/// The worker run by the calling thread, NULL outside of the workers
+static _Thread_local travailleur_t *travailleur_courant = NULL;
+
+/**
+ * @brief Wakes one sleeping worker, if any, after a task was made available.
+ *
+ * A worker announces that it sleeps, then looks for work under the lock before waiting, with a fence
+ * between the two: either it sees the task, or the load below sees it asleep and the signal is sent under
+ * the lock, once it waits.
+ */
+static void reveiller(ordonnanceur_t *ordonnanceur)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&ordonnanceur->endormis, memory_order_relaxed) > 0)
+    {
+        pthread_mutex_lock(&ordonnanceur->verrou);
+        pthread_cond_signal(&ordonnanceur->travail);
+        pthread_mutex_unlock(&ordonnanceur->verrou);
+    }
+}
+
+/**
+ * @brief Tells whether some task is waiting anywhere in the scheduler.
+ */
+static int travail_disponible(ordonnanceur_t *ordonnanceur)
+{
+    if (atomic_load(&ordonnanceur->nb_exterieures) > 0)
+        return 1;
+    for (int i = 0; i < ordonnanceur->nb_travailleurs; i++)
+    {
+        if (deque_vol_taille(&ordonnanceur->travailleurs[i].deque) > 0)
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Looks for a task: on top of the own deque, then among the tasks submitted from outside, then at the
+ *        base of the deques of the other workers, starting with a random one.
+ *
+ * @return The task, or NULL if none was found after TOURS_VOL rounds.
+ */
+static tache_t *trouver_tache(travailleur_t *travailleur)
+{
+    ordonnanceur_t *ordonnanceur = travailleur->ordonnanceur;
+    void *tache;
+
+    if (deque_vol_depiler(&travailleur->deque, &tache) == 0)
+        return tache;
+
+    for (int tour = 0; tour < TOURS_VOL; tour++)
+    {
+        if (atomic_load_explicit(&ordonnanceur->nb_exterieures, memory_order_relaxed) > 0)
+        {
+            tache_t *exterieure = NULL;
+            pthread_mutex_lock(&ordonnanceur->verrou);
+            if (file_taches_defiler(&ordonnanceur->exterieures, &exterieure) == 0)
+                atomic_fetch_sub(&ordonnanceur->nb_exterieures, 1);
+            pthread_mutex_unlock(&ordonnanceur->verrou);
+            if (exterieure)
+                return exterieure;
+        }
+
+        // xorshift32
+        travailleur->alea ^= travailleur->alea << 13;
+        travailleur->alea ^= travailleur->alea >> 17;
+        travailleur->alea ^= travailleur->alea << 5;
+
+        int nb = ordonnanceur->nb_travailleurs;
+        int victime = (int) (travailleur->alea % (unsigned int) nb);
+        for (int i = 0; i < nb; i++, victime = (victime + 1) % nb)
+        {
+            if (victime != travailleur->indice
+                && deque_vol_voler(&ordonnanceur->travailleurs[victime].deque, &tache) == 0)
+                return tache;
+        }
+
+        sched_yield();
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Runs a task and frees it, waking the threads waiting for the scheduler if it was the last one.
+ */
+static void executer(ordonnanceur_t *ordonnanceur, tache_t *tache)
+{
+    tache->fonction(ordonnanceur, tache->argument);
+    free(tache);
+
+    if (atomic_fetch_sub(&ordonnanceur->en_cours, 1) == 1)
+    {
+        pthread_mutex_lock(&ordonnanceur->verrou);
+        pthread_cond_broadcast(&ordonnanceur->termine);
+        pthread_mutex_unlock(&ordonnanceur->verrou);
+    }
+}
+
+/**
+ * @brief Body of a worker thread: runs tasks until the scheduler stops, sleeping when there are none.
+ *
+ * @param argument Pointer to the travailleur_t of the thread.
+ * @return NULL
+ */
+static void *travailler(void *argument)
+{
+    travailleur_t *travailleur = argument;
+    ordonnanceur_t *ordonnanceur = travailleur->ordonnanceur;
+    travailleur_courant = travailleur;
+
+    while (!atomic_load(&ordonnanceur->arret))
+    {
+        tache_t *tache = trouver_tache(travailleur);
+        if (tache)
+        {
+            executer(ordonnanceur, tache);
+            continue;
+        }
+
+        pthread_mutex_lock(&ordonnanceur->verrou);
+        atomic_fetch_add(&ordonnanceur->endormis, 1);
+        atomic_thread_fence(memory_order_seq_cst);
+        while (!atomic_load(&ordonnanceur->arret) && !travail_disponible(ordonnanceur))
+            pthread_cond_wait(&ordonnanceur->travail, &ordonnanceur->verrou);
+        atomic_fetch_sub(&ordonnanceur->endormis, 1);
+        pthread_mutex_unlock(&ordonnanceur->verrou);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Frees what ordonnanceur_demarrer allocated for the first nb_deques workers.
+ */
+static void liberer(ordonnanceur_t *ordonnanceur, int nb_deques)
+{
+    for (int i = 0; i < nb_deques; i++)
+        deque_vol_detruire(&ordonnanceur->travailleurs[i].deque);
+    free(ordonnanceur->travailleurs);
+    file_taches_detruire(&ordonnanceur->exterieures);
+    pthread_cond_destroy(&ordonnanceur->termine);
+    pthread_cond_destroy(&ordonnanceur->travail);
+    pthread_mutex_destroy(&ordonnanceur->verrou);
+}
+
+/**
+ * @brief Starts a scheduler.
+ *
+ * @param ordonnanceur The scheduler.
+ * @param nb_travailleurs The number of workers, from 1 to TRAVAILLEURS_MAX, or 0 for one per processor.
+ * @return 0 on success, -1 on error (memory allocation or thread creation failed).
+ */
+int ordonnanceur_demarrer(ordonnanceur_t *ordonnanceur, int nb_travailleurs)
+{
+    if (nb_travailleurs == 0)
+        nb_travailleurs = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (nb_travailleurs < 1)
+        nb_travailleurs = 1;
+    if (nb_travailleurs > TRAVAILLEURS_MAX)
+        nb_travailleurs = TRAVAILLEURS_MAX;
+
+    pthread_mutex_init(&ordonnanceur->verrou, NULL);
+    pthread_cond_init(&ordonnanceur->travail, NULL);
+    pthread_cond_init(&ordonnanceur->termine, NULL);
+    atomic_init(&ordonnanceur->nb_exterieures, 0);
+    atomic_init(&ordonnanceur->endormis, 0);
+    atomic_init(&ordonnanceur->en_cours, 0);
+    atomic_init(&ordonnanceur->arret, 0);
+    ordonnanceur->nb_travailleurs = nb_travailleurs;
+
+    // the deques are aligned on cache lines, which malloc does not guarantee
+    ordonnanceur->travailleurs = aligned_alloc(TAILLE_LIGNE_CACHE, nb_travailleurs * sizeof(travailleur_t));
+    if (file_taches_initialiser(&ordonnanceur->exterieures) == -1 || !ordonnanceur->travailleurs)
+    {
+        liberer(ordonnanceur, 0);
+        return -1;
+    }
+
+    for (int i = 0; i < nb_travailleurs; i++)
+    {
+        travailleur_t *travailleur = &ordonnanceur->travailleurs[i];
+        if (deque_vol_initialiser(&travailleur->deque) == -1)
+        {
+            liberer(ordonnanceur, i);
+            return -1;
+        }
+        travailleur->ordonnanceur = ordonnanceur;
+        travailleur->indice = i;
+        travailleur->alea = 2463534242u + (unsigned int) i;
+    }
+
+    for (int i = 0; i < nb_travailleurs; i++)
+    {
+        if (pthread_create(&ordonnanceur->travailleurs[i].thread, NULL, travailler, &ordonnanceur->travailleurs[i]) != 0)
+        {
+            // the workers already started are stopped, there is no task yet
+            pthread_mutex_lock(&ordonnanceur->verrou);
+            atomic_store(&ordonnanceur->arret, 1);
+            pthread_cond_broadcast(&ordonnanceur->travail);
+            pthread_mutex_unlock(&ordonnanceur->verrou);
+            for (int j = 0; j < i; j++)
+                pthread_join(ordonnanceur->travailleurs[j].thread, NULL);
+            liberer(ordonnanceur, nb_travailleurs);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Submits a task, from a task of the scheduler or from any other thread.
+ *
+ * @return 0 on success, -1 if memory allocation failed, the task not being submitted.
+ */
+int ordonnanceur_soumettre(ordonnanceur_t *ordonnanceur, fonction_tache fonction, void *argument)
+{
+    tache_t *tache = malloc(sizeof(tache_t));
+    if (!tache)
+        return -1;
+    tache->fonction = fonction;
+    tache->argument = argument;
+
+    atomic_fetch_add(&ordonnanceur->en_cours, 1);
+
+    travailleur_t *travailleur = travailleur_courant;
+    if (!travailleur || travailleur->ordonnanceur != ordonnanceur || deque_vol_empiler(&travailleur->deque, tache) == -1)
+    {
+        pthread_mutex_lock(&ordonnanceur->verrou);
+        int resultat = file_taches_enfiler(&ordonnanceur->exterieures, tache);
+        if (resultat == 0)
+            atomic_fetch_add(&ordonnanceur->nb_exterieures, 1);
+        pthread_mutex_unlock(&ordonnanceur->verrou);
+
+        if (resultat == -1)
+        {
+            atomic_fetch_sub(&ordonnanceur->en_cours, 1);
+            free(tache);
+            return -1;
+        }
+    }
+
+    reveiller(ordonnanceur);
+    return 0;
+}
+
+/**
+ * @brief Waits until every task submitted, and every task they submitted, is over. Not called by a task.
+ */
+void ordonnanceur_attendre(ordonnanceur_t *ordonnanceur)
+{
+    pthread_mutex_lock(&ordonnanceur->verrou);
+    while (atomic_load(&ordonnanceur->en_cours) > 0)
+        pthread_cond_wait(&ordonnanceur->termine, &ordonnanceur->verrou);
+    pthread_mutex_unlock(&ordonnanceur->verrou);
+}
+
+/**
+ * @brief Waits for the pending tasks, then stops the workers and frees the scheduler.
+ */
+void ordonnanceur_arreter(ordonnanceur_t *ordonnanceur)
+{
+    ordonnanceur_attendre(ordonnanceur);
+
+    pthread_mutex_lock(&ordonnanceur->verrou);
+    atomic_store(&ordonnanceur->arret, 1);
+    pthread_cond_broadcast(&ordonnanceur->travail);
+    pthread_mutex_unlock(&ordonnanceur->verrou);
+
+    for (int i = 0; i < ordonnanceur->nb_travailleurs; i++)
+        pthread_join(ordonnanceur->travailleurs[i].thread, NULL);
+
+    liberer(ordonnanceur, ordonnanceur->nb_travailleurs);
+}
+
+/// A node of the uneven tree of the test, allocated on the heap and freed by the task visiting it
+typedef struct
+{
+    int profondeur;
+    atomic_long *visites;
+} noeud_test;
+
+/**
+ * @brief Returns the number of nodes of the tree of the test below a node of a given depth, itself included.
+ */
+static long compter_noeuds(int profondeur)
+{
+    if (profondeur <= 0)
+        return 1;
+    return 1 + compter_noeuds(profondeur - 1) + compter_noeuds(profondeur / 2);
+}
+
+/**
+ * @brief Submits a task visiting a new node of the tree of the test.
+ */
+static void soumettre_noeud(ordonnanceur_t *ordonnanceur, int profondeur, atomic_long *visites);
+
+/**
+ * @brief Task visiting a node of the tree of the test: a node of depth d has children of depths d - 1 and d / 2,
+ *        so that the left subtrees are much deeper than the right ones.
+ */
+static void visiter(ordonnanceur_t *ordonnanceur, void *argument)
+{
+    noeud_test *noeud = argument;
+
+    atomic_fetch_add(noeud->visites, 1);
+    if (noeud->profondeur > 0)
+    {
+        soumettre_noeud(ordonnanceur, noeud->profondeur - 1, noeud->visites);
+        soumettre_noeud(ordonnanceur, noeud->profondeur / 2, noeud->visites);
+    }
+    free(noeud);
+}
+
+static void soumettre_noeud(ordonnanceur_t *ordonnanceur, int profondeur, atomic_long *visites)
+{
+    noeud_test *noeud = malloc(sizeof(noeud_test));
+    assert(noeud);
+    noeud->profondeur = profondeur;
+    noeud->visites = visites;
+    assert(ordonnanceur_soumettre(ordonnanceur, visiter, noeud) == 0);
+}
+
+/**
+ * @brief Tests the scheduler: every node of an uneven tree of tasks, submitted from several roots, is visited
+ *        exactly once, whatever the number of workers.
+ */
+void test_ordonnanceur(void)
+{
+    int racines[] = {14, 10, 0};
+
+    for (int nb_travailleurs = 1; nb_travailleurs <= 4; nb_travailleurs *= 2)
+    {
+        ordonnanceur_t ordonnanceur;
+        atomic_long visites;
+        long attendues = 0;
+
+        atomic_init(&visites, 0);
+        assert(ordonnanceur_demarrer(&ordonnanceur, nb_travailleurs) == 0);
+        for (int i = 0; i < 3; i++)
+        {
+            soumettre_noeud(&ordonnanceur, racines[i], &visites);
+            attendues += compter_noeuds(racines[i]);
+        }
+        ordonnanceur_attendre(&ordonnanceur);
+        assert(atomic_load(&visites) == attendues);
+
+        ordonnanceur_arreter(&ordonnanceur);
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * @file ordonnanceur.h
+ * @brief Work-stealing scheduler of tasks on a pool of threads.
+ *
+ * Every worker owns a deque_vol_t. A task submitted by a running task goes on top of the deque of its worker,
+ * which runs it next, newest first, as a recursive call would: a tree walk goes depth first on each worker
+ * and its memory stays bounded by the depth. A worker whose deque is empty takes the tasks submitted from
+ * outside the pool, then steals the oldest task of another worker, which is the root of its largest pending
+ * subtree: an uneven tree ends up spread across the workers without any partitioning beforehand.
+ *
+ * Idle workers sleep on a condition variable after a few unsuccessful rounds of stealing, and are woken
+ * when a task is submitted.
+ */
+
+#ifndef R305_ORDONNANCEUR_H
+#define R305_ORDONNANCEUR_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "deque_vol.h"
+#include "conteneurs.h"
+
+/// Largest number of workers of a scheduler
+#define TRAVAILLEURS_MAX 256
+
+/// Number of rounds of stealing from every other worker before an idle worker sleeps
+#define TOURS_VOL 4
+
+typedef struct ordonnanceur ordonnanceur_t;
+
+/// A function run as a task, which may submit more tasks to the scheduler it receives
+typedef void (*fonction_tache)(ordonnanceur_t *ordonnanceur, void *argument);
+
+/// A task waiting to be run
+typedef struct
+{
+    fonction_tache fonction;
+    void *argument;
+} tache_t;
+
+DEFINIR_FILE(file_taches, tache_t *, 16)
+
+/// A worker thread and its deque
+typedef struct
+{
+    deque_vol_t deque;
+    ordonnanceur_t *ordonnanceur;
+    int indice;
+    unsigned int alea;   ///< state of the choice of the victims
+    pthread_t thread;
+} travailleur_t;
+
+/// A pool of workers
+struct ordonnanceur
+{
+    travailleur_t *travailleurs;
+    int nb_travailleurs;
+
+    pthread_mutex_t verrou;
+    file_taches_t exterieures;      ///< tasks submitted from outside the pool, under the lock
+    atomic_int nb_exterieures;      ///< number of elements of exterieures, read without the lock
+    pthread_cond_t travail;         ///< signalled when a task is submitted and a worker sleeps
+    pthread_cond_t termine;         ///< signalled when the last pending task is over
+    atomic_int endormis;            ///< number of workers sleeping on travail
+    atomic_long en_cours;           ///< number of tasks submitted and not over yet
+    atomic_int arret;               ///< 1 once the workers must stop
+};
+
+/**
+ * @brief Starts a scheduler.
+ *
+ * @param ordonnanceur The scheduler.
+ * @param nb_travailleurs The number of workers, from 1 to TRAVAILLEURS_MAX, or 0 for one per processor.
+ * @return 0 on success, -1 on error (memory allocation or thread creation failed).
+ */
+int ordonnanceur_demarrer(ordonnanceur_t *ordonnanceur, int nb_travailleurs);
+
+/**
+ * @brief Submits a task, from a task of the scheduler or from any other thread.
+ *
+ * @return 0 on success, -1 if memory allocation failed, the task not being submitted.
+ */
+int ordonnanceur_soumettre(ordonnanceur_t *ordonnanceur, fonction_tache fonction, void *argument);
+
+/**
+ * @brief Waits until every task submitted, and every task they submitted, is over. Not called by a task.
+ */
+void ordonnanceur_attendre(ordonnanceur_t *ordonnanceur);
+
+/**
+ * @brief Waits for the pending tasks, then stops the workers and frees the scheduler.
+ */
+void ordonnanceur_arreter(ordonnanceur_t *ordonnanceur);
+
+void test_ordonnanceur(void);
+
+#endif //R305_ORDONNANCEUR_H
@@ -2,8 +2,8 @@
  * @file queue_and_stack_operations.h
  * @brief Handles Operations on Stacks and Queues
  *
- * This file contains functions that manage operations on
- * fixed-size and variable-size stacks and queues (files).
+ * The fixed-size and variable-size stacks and queues (files) of int are
+ * instantiations of the macros of conteneurs.h; this file displays and tests them.
  *
  * @author Lilith Camplin
  * @date 2023-10-17
@@ -11,75 +11,27 @@
 #include <stdio.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
 #include "queue_and_stack_operations.h"
-
-/**
- * @function void pile_fixe_initialiser(pile_fixe_t *pile)
- * @brief Initializes a fixed-size stack
- *
- * Sets all elements of a fixed-size stack (pile_fixe_t) to zero.
- *
- * @param pile Pointer to the fixed-size stack structure (pile_fixe_t).
- */
-void pile_fixe_initialiser(pile_fixe_t *pile)
+#include "file_spsc.h"
+#include "file_mpmc.h"
+#include "file_blocs.h"
+#include "tas.h"
+#include "deque_vol.h"
+#include "ordonnanceur.h"
+#include "conteneurs_banc.h"
+
+/// Un élément plus gros qu'un registre, pour tester les conteneurs génériques
+typedef struct
 {
-    pile->sommet = -1;
-}
+    uint64_t identifiant;
+    double poids;
+} paire_t;
 
-/**
- * @function int pile_fixe_est_vide(const pile_fixe_t *pile)
- * @brief Checks if the given fixed-size stack is empty
- *
- * Checks if the given fixed-size stack is empty.
- *
- * @param pile Pointer to the fixed-size stack to be checked
- * @return 1 if the stack is empty, 0 otherwise
- */
-int pile_fixe_est_vide(const pile_fixe_t *pile)
-{
-    return pile->sommet == -1 ? 1 : 0;
-}
-
-/**
- * @function int pile_fixe_empiler(pile_fixe_t *pile, element_t element)
- * @brief Pushes an element onto the fixed-size stack.
- *
- * Adds an item to the given fixed-size stack and checks for overflow.
- *
- * @param pile The fixed-size stack.
- * @param element The element to be added to the stack.
- * @return Returns 0 if the operation is successful or -1 if the stack is full.
- */
-int pile_fixe_empiler(pile_fixe_t *pile, element_t const element)
-{
-    if (pile->sommet >= TAILLE_PILE - 1)
-        return -1;
-
-    pile->pile[++pile->sommet] = element;
-    return 0;
-}
-
-/**
- * @brief Pops an element from the top of the fixed-size stack.
- *
- * This function removes the element at the top of the fixed-size stack and stores it in the given variable.
- *
- * @param pile Pointer to the fixed-size stack.
- * @param p_element Pointer to the variable where the popped element will be stored.
- *
- * @return Returns 0 if the operation is successful, else returns -1 if the fixed-size stack is empty.
- *
- * @note The fixed-size stack should be initialized by the pile_fixe_initialiser() function before calling this function.
- * @note The variable pointed by p_element should have enough memory to accommodate the popped element.
- */
-int pile_fixe_depiler(pile_fixe_t *pile, element_t *p_element)
-{
-    if (pile_fixe_est_vide(pile))
-        return -1;
-
-    *p_element = pile->pile[pile->sommet--];
-    return 0;
-}
+DEFINIR_PILE(pile_paires, paire_t, 2)
+DEFINIR_FILE(file_chaines, const char *, 2)
 
 /**
  * @brief Affiche les éléments de la pile fixe.
@@ -98,74 +50,6 @@ void pile_fixe_afficher(const pile_fixe_t *pile)
     printf("|\n");
 }
 
-/**
- * @brief Initializes a pile_variable_t structure.
- *
- * This function initializes a pile_variable_t structure by setting its initial values.
- *
- * @param pile A pointer to the pile_variable_t structure to be initialized.
- */
-int pile_variable_initialiser(pile_variable_t *pile)
-{
-    pile->sommet = -1;
-    pile->taille = PAS_ALLOCATION;
-    pile->pile = malloc(sizeof(element_t) * pile->taille);
-    if (!pile->pile) return -1; // Fail to allocate memory
-
-    return 0;
-}
-
-int pile_variable_est_vide(const pile_variable_t *pile)
-{
-    return pile->sommet == -1 ? 1 : 0;
-}
-
-/**
- * @brief Pushes an element onto the variable stack.
- *
- * @param pile The variable stack.
- * @param element The element to be pushed onto the stack.
- */
-int pile_variable_empiler(pile_variable_t *pile, element_t const element)
-{
-    if (pile->sommet >= pile->taille - 1)
-    {
-        // If the stack is full
-        pile->taille += PAS_ALLOCATION; // Increase the stack size
-        pile->pile = realloc(pile->pile, sizeof(element_t) * pile->taille); // Reallocate memory
-        if (!pile->pile) return -1; // Fail to allocate memory
-    }
-
-    pile->pile[++pile->sommet] = element; // Push the element
-
-    return 0;
-}
-
-/**
- * @brief Depiles an element from a stack and assigns it to the given pointer.
- *
- * This function removes the top element from the specified stack and
- * assigns it to the given pointer.
- *
- * @param pile   Pointer to the stack structure.
- * @param p_element Pointer to the variable to store the depiled element.
- */
-int pile_variable_depiler(pile_variable_t *pile, element_t *p_element)
-{
-    if (pile_variable_est_vide(pile)) return -1; // The stack is empty
-
-    *p_element = pile->pile[pile->sommet--]; // Pop the element
-
-    if (pile->sommet < pile->taille - PAS_ALLOCATION)
-    {
-        // If the number of elements in the stack is smaller than the size of the stack by PAS_ALLOCATION
-        pile->taille -= PAS_ALLOCATION; // Decrease the size
-        pile->pile = realloc(pile->pile, sizeof(element_t) * pile->taille); // Reallocate memory
-    }
-
-    return 0;
-}
-
 /**
  * @brief Afficher les éléments d'une pile de variables.
  *
@@ -181,228 +65,32 @@ void pile_variable_afficher(const pile_variable_t *pile)
     printf("|\n");
 }
 
-/**
- * @brief Destroys a given stack of variables.
- *
- * This function is responsible for destroying the stack of variables,
- * deallocating memory occupied by each variable and freeing the memory
- * occupied by the stack itself.
- *
- * @param pile Pointer to the stack of variables to be destroyed
- *
- * @remarks The function assumes that the stack of variables is not
- *          empty and that the 'pile' parameter is a valid pointer.
- *          After calling this function, the 'pile' pointer should
- *          no longer be used.
- *
- * @see pile_variable_t
- */
-void pile_variable_detruire(pile_variable_t *pile)
-{
-    free(pile->pile);
-    pile->pile = NULL;
-    pile->sommet = -1;
-    pile->taille = 0;
-}
-
-/**
- * @brief Initializes a fixed size file.
- *
- * This function initializes a fixed size file by setting the initial values of its properties.
- * It takes a pointer to a file_fixe_t structure as parameter and initializes the members of the structure.
- *
- * @param file A pointer to the file_fixe_t structure to be initialized.
- */
-void file_fixe_initialiser(file_fixe_t *file)
-{
-    file->head = -1;
-    file->tail = 0;
-}
-
-/**
- * @brief Check if the given file is empty.
- *
- * @param file The file to check.
- * @return True if the file is empty, false otherwise.
- */
-int file_fixe_est_vide(const file_fixe_t *file)
-{
-    return file->head == -1 ? 1 : 0;
-}
-
-/**
- * @brief Enqueues an element into a fixed-size file.
- *
- * This function enqueues an element into a fixed-size file, represented by
- * the given file_fixe_t structure.
- *
- * @param file A pointer to the file_fixe_t structure representing the fixed-size file.
- * @param element The element to be enqueued into the file.
- */
-int file_fixe_enfiler(file_fixe_t *file, element_t const element)
-{
-    if (file->tail == TAILLE_FILE)
-        return -1;
-
-    file->file[file->tail++] = element;
-
-    if (file->head == -1)
-        file->head = 0;
-
-    return 0;
-}
-
-int file_fixe_defiler(file_fixe_t *file, element_t *p_element)
-{
-    if (file_fixe_est_vide(file))
-        return -1;
-
-    *p_element = file->file[file->head++];
-
-    if (file->head == file->tail)
-    {
-        // The queue is empty
-        file->head = -1;
-        file->tail = 0;
-    }
-
-    return 0;
-}
-
 /**
  * @file queue_and_stack_operations.h
  * @brief Documentation for the file_fixe_afficher function.
  */
 void file_fixe_afficher(const file_fixe_t *file)
 {
-    for (int i = file->head; i < file->tail; i++)
-        printf("| %d ", file->file[i]);
+    for (int i = 0, j = file->head; i < file->nombre; i++, j = j + 1 == TAILLE_FILE ? 0 : j + 1)
+        printf("| %d ", file->file[j]);
     printf("|\n");
 }
 
-/**
- * @brief Initializes the file_variable_t structure.
- *
- * This function initializes the members of the file_variable_t structure with default values.
- * It is recommended to call this function before using the file_variable_t object.
- *
- * @param file A pointer to the file_variable_t structure.
- */
-int file_variable_initialiser(file_variable_t *file)
-{
-    file->taille = TAILLE_FILE;
-    file->head = -1;
-    file->tail = 0;
-    file->file = (element_t *) malloc(sizeof(element_t) * file->taille);
-    if (!file->file) return -1; // Fail to allocate memory
-
-    return 0;
-}
-
-/**
- * @brief Check if the given file variable is empty.
- *
- * This function checks if the file variable is empty, which means it contains no data or has a size of 0.
- *
- * @param file The file variable to check.
- * @return True if the file variable is empty, False otherwise.
- */
-int file_variable_est_vide(const file_variable_t *file)
-{
-    return file->head == -1 ? 1 : 0;
-}
-
-/**
- * @brief Enfiles an element to a file variable.
- *
- * This function enfiles an element to the specified file variable.
- *
- * @param file The file variable to enfile the element into.
- * @param element The element to enfile.
- */
-int file_variable_enfiler(file_variable_t *file, element_t const element)
-{
-    if (file->tail == file->taille)
-    {
-        // if the queue is full
-        file->taille += PAS_ALLOCATION; // increase the size
-        file->file = (element_t *) realloc(file->file, sizeof(element_t) * file->taille); // reallocate memory
-        if (!file->file) return -1; // Fail to allocate memory
-    }
-
-    file->file[file->tail++] = element;
-
-    if (file->head == -1)
-        file->head = 0;
-
-    return 0;
-}
-
-/**
- * @brief This file declares the function to defile a file variable using an element.
- *
- * The file_variable_defiler() function defiles the given file variable using the provided element.
- * Defiling a file variable means to manipulate its contents based on the element, typically by removing
- * certain parts or modifying their values.
- */
-int file_variable_defiler(file_variable_t *file, element_t *p_element)
-{
-    if (file_variable_est_vide(file))
-        return -1;
-
-    *p_element = file->file[file->head++];
-
-    if (file->head == file->tail)
-    {
-        // The queue is empty
-        file->head = -1;
-        file->tail = 0;
-        file->taille = TAILLE_FILE;
-        file->file = (element_t *) realloc(file->file, sizeof(element_t) * file->taille);
-    } else if (file->tail - file->head < file->taille - PAS_ALLOCATION)
-    {
-        // if the empty space is bigger than PAS_ALLOCATION
-        file->taille -= PAS_ALLOCATION; // decrease the size
-        file->file = (element_t *) realloc(file->file, sizeof(element_t) * file->taille); // reallocate memory
-    }
-
-    return 0;
-}
-
 /**
  * @brief Display the contents of the file_variable.
  *
- * This function displays the contents of the given file_variable.
- * The file_variable contains information about a file, such as its name,
- * size, and permissions.
+ * This function displays the elements of the given file_variable, from the first to the last.
  *
  * @param file Pointer to the file_variable to be displayed.
  * @return void
  */
 void file_variable_afficher(const file_variable_t *file)
 {
-    for (int i = file->head; i < file->tail; i++)
-        printf("| %d ", file->file[i]);
+    for (int i = 0, j = file->head; i < file->nombre; i++, j = j + 1 == file->taille ? 0 : j + 1)
+        printf("| %d ", file->file[j]);
     printf("|\n");
 }
 
-/**
- * @brief Destroys a file_variable_t object.
- *
- * This function is used to destroy a file_variable_t object, freeing up any allocated memory and
- * resources associated with it. It is important to call this function when the object is no
- * longer needed to avoid memory leaks.
- *
- * @param file A pointer to the file_variable_t object to destroy.
- */
-void file_variable_detruire(file_variable_t *file)
-{
-    free(file->file);
-    file->file = NULL;
-    file->head = -1;
-    file->tail = 0;
-}
-
 /**
  * @brief Function to test the fixed-size stack class.
  *
@@ -502,6 +190,34 @@ void test_pile_variable(void)
 
     assert(pile_variable_est_vide(&pile));
 
+    // Pushing and popping around a size does not reallocate
+    for (int i = 0; i < 8; i++)
+        assert(pile_variable_empiler(&pile, i) == 0);
+    element_t *tableau = pile.pile;
+    int taille = pile.taille;
+    for (int i = 0; i < 100; i++)
+    {
+        assert(pile_variable_empiler(&pile, i) == 0);
+        assert(pile_variable_depiler(&pile, &e) == 0);
+        assert(e == i);
+    }
+    assert(pile.pile == tableau && pile.taille == taille);
+
+    // A reserved stack keeps its size, an adjusted one fits its elements
+    assert(pile_variable_reserver(&pile, 1000) == 0);
+    assert(pile.taille == 1000);
+    for (int i = 7; i >= 0; i--)
+    {
+        assert(pile_variable_depiler(&pile, &e) == 0);
+        assert(e == i);
+    }
+    assert(pile.taille == 1000);
+    assert(pile_variable_empiler(&pile, 42) == 0);
+    assert(pile_variable_ajuster(&pile) == 0);
+    assert(pile.taille == 1);
+    assert(pile_variable_depiler(&pile, &e) == 0);
+    assert(e == 42);
+
     pile_variable_detruire(&pile);
 }
 
@@ -631,22 +347,302 @@ void test_file_variable(void)
 
     assert(file_variable_est_vide(&file));
 
+    // The elements wrap around the end of the array while it grows and shrinks
+    int suivant = 0, attendu = 0;
+    for (int tour = 0; tour < 1000; tour++)
+    {
+        assert(file_variable_enfiler(&file, suivant++) == 0);
+        assert(file_variable_enfiler(&file, suivant++) == 0);
+        assert(file_variable_defiler(&file, &e) == 0);
+        assert(e == attendu++);
+    }
+    assert(file.nombre == 1000);
+    assert(file.taille >= 1000 && file.taille < 4000);
+    while (file_variable_defiler(&file, &e) == 0)
+        assert(e == attendu++);
+    assert(attendu == suivant);
+    assert(file.taille < 2 * TAILLE_FILE);
+
     file_variable_detruire(&file);
 }
 
 /**
- * @brief Performs various operations on queue and stack data structures.
+ * @brief Tests containers of other element types than int: a structure and a pointer.
+ */
+void test_conteneurs(void)
+{
+    pile_paires_t pile;
+    paire_t paire;
+
+    assert(pile_paires_initialiser(&pile) == 0);
+    for (uint64_t i = 0; i < 100; i++)
+        assert(pile_paires_empiler(&pile, (paire_t) {i << 40, i / 2.0}) == 0);
+    for (uint64_t i = 100; i-- > 0;)
+    {
+        assert(pile_paires_depiler(&pile, &paire) == 0);
+        assert(paire.identifiant == i << 40 && paire.poids == i / 2.0);
+    }
+    assert(pile_paires_depiler(&pile, &paire) == -1);
+    pile_paires_detruire(&pile);
+
+    const char *mots[] = {"un", "deux", "trois", "quatre", "cinq"};
+    file_chaines_t file;
+    const char *mot;
+
+    assert(file_chaines_initialiser(&file) == 0);
+    for (int tour = 0; tour < 3; tour++)
+    {
+        for (int i = 0; i < 5; i++)
+            assert(file_chaines_enfiler(&file, mots[i]) == 0);
+        for (int i = 0; i < 5; i++)
+        {
+            assert(file_chaines_defiler(&file, &mot) == 0);
+            assert(mot == mots[i]);
+        }
+    }
+    assert(file_chaines_est_vide(&file));
+    file_chaines_detruire(&file);
+}
+
+/// La file_variable_t d'origine, gardée pour la mesure : elle ne réutilise
+/// jamais le début du tableau tant qu'elle n'a pas été vidée entièrement
+typedef struct
+{
+    element_t *file;
+    int head;
+    int tail;
+    int taille;
+} file_lineaire_t;
+
+static int file_lineaire_initialiser(file_lineaire_t *file)
+{
+    file->taille = TAILLE_FILE;
+    file->head = -1;
+    file->tail = 0;
+    file->file = (element_t *) malloc(sizeof(element_t) * file->taille);
+    return file->file ? 0 : -1;
+}
+
+static int file_lineaire_enfiler(file_lineaire_t *file, element_t const element)
+{
+    if (file->tail == file->taille)
+    {
+        element_t *tableau = (element_t *) realloc(file->file, sizeof(element_t) * (file->taille + PAS_ALLOCATION));
+        if (!tableau) return -1;
+        file->file = tableau;
+        file->taille += PAS_ALLOCATION;
+    }
+
+    file->file[file->tail++] = element;
+    if (file->head == -1)
+        file->head = 0;
+    return 0;
+}
+
+static int file_lineaire_defiler(file_lineaire_t *file, element_t *p_element)
+{
+    if (file->head == -1)
+        return -1;
+
+    *p_element = file->file[file->head++];
+    if (file->head == file->tail)
+    {
+        file->head = -1;
+        file->tail = 0;
+        file->taille = TAILLE_FILE;
+        file->file = (element_t *) realloc(file->file, sizeof(element_t) * file->taille);
+    } else if (file->tail <= file->taille - PAS_ALLOCATION)
+    {
+        file->taille -= PAS_ALLOCATION;
+        file->file = (element_t *) realloc(file->file, sizeof(element_t) * file->taille);
+    }
+    return 0;
+}
+
+/// Les opérations d'une des deux files mesurées
+typedef struct
+{
+    const char *nom;
+    int (*enfiler)(void *file, element_t element);
+    int (*defiler)(void *file, element_t *p_element);
+    int (*taille)(const void *file);
+} operations_file;
+
+static int enfiler_circulaire(void *file, element_t element) { return file_variable_enfiler(file, element); }
+static int defiler_circulaire(void *file, element_t *p_element) { return file_variable_defiler(file, p_element); }
+static int taille_circulaire(const void *file) { return ((const file_variable_t *) file)->taille; }
+static int enfiler_lineaire(void *file, element_t element) { return file_lineaire_enfiler(file, element); }
+static int defiler_lineaire(void *file, element_t *p_element) { return file_lineaire_defiler(file, p_element); }
+static int taille_lineaire(const void *file) { return ((const file_lineaire_t *) file)->taille; }
+
+/**
+ * @brief Returns the current time of the monotonic clock in seconds.
+ */
+static double maintenant(void)
+{
+    struct timespec temps;
+    clock_gettime(CLOCK_MONOTONIC, &temps);
+    return temps.tv_sec + temps.tv_nsec / 1e9;
+}
+
+/// Les mesures d'une des deux files
+typedef struct
+{
+    int taille;             ///< size of the array after the last operation
+    int taille_max;         ///< largest size of the array
+    long redimensions;      ///< number of times the array was resized
+    int erreurs;            ///< number of failed operations and of elements out of order
+} mesures_file;
+
+/**
+ * @brief Records the size of the array of a file after an operation.
+ */
+static void noter_taille(const operations_file *operations, const void *file, mesures_file *mesures)
+{
+    int taille = operations->taille(file);
+    if (taille != mesures->taille)
+    {
+        mesures->redimensions++;
+        mesures->taille = taille;
+        if (taille > mesures->taille_max)
+            mesures->taille_max = taille;
+    }
+}
+
+/**
+ * @brief Runs OPERATIONS_BANC_FILE operations on a file and prints the time taken, the largest array and the
+ *        number of resizes.
+ *
+ * @param operations The operations of the file.
+ * @param file The empty file.
+ * @param profondeur 0 to enfile half of the elements then defile them all, otherwise the number of elements
+ *                   kept in the file while one is enfiled and one defiled at each step.
+ * @return 0 if the elements came out in order, -1 otherwise.
+ */
+static int mesurer_file(const operations_file *operations, void *file, int profondeur)
+{
+    element_t suivant = 0, attendu = 0, e;
+    mesures_file mesures = {operations->taille(file), operations->taille(file), 0, 0};
+    int limite = profondeur ? profondeur : OPERATIONS_BANC_FILE / 2;
+    double debut = maintenant();
+
+    while (suivant < limite)
+    {
+        mesures.erreurs += operations->enfiler(file, suivant++) != 0;
+        noter_taille(operations, file, &mesures);
+    }
+    while (profondeur && suivant + attendu < OPERATIONS_BANC_FILE)
+    {
+        mesures.erreurs += operations->enfiler(file, suivant++) != 0;
+        noter_taille(operations, file, &mesures);
+        mesures.erreurs += operations->defiler(file, &e) != 0 || e != attendu++;
+        noter_taille(operations, file, &mesures);
+    }
+    while (operations->defiler(file, &e) == 0)
+    {
+        mesures.erreurs += e != attendu++;
+        noter_taille(operations, file, &mesures);
+    }
+
+    double duree = maintenant() - debut;
+    int resultat = mesures.erreurs || attendu != suivant ? -1 : 0;
+    printf("%-18s %-20s %9.2f ms  largest array %9d  resizes %8ld  %s\n", operations->nom,
+           profondeur ? "steady, depth 1000" : "fill then drain", duree * 1e3, mesures.taille_max,
+           mesures.redimensions, resultat == 0 ? "ok" : "OUT OF ORDER");
+    return resultat;
+}
+
+/**
+ * @brief Compares file_variable_t with its original version, which grew by PAS_ALLOCATION elements and only
+ *        reused the start of its array once emptied, on OPERATIONS_BANC_FILE operations.
  *
- * This function demonstrates the usage of different operations for queue and stack data structures.
- * It creates a queue and a stack, then performs a series of operations on them such as insertion,
- * deletion, checking if empty, and printing the elements.
+ * @return 0 on success, -1 if memory allocation failed or an element was lost.
  */
-int run_queue_and_stack_operations(void)
+int banc_file_variable(void)
 {
+    const operations_file circulaire = {"file_variable_t", enfiler_circulaire, defiler_circulaire, taille_circulaire};
+    const operations_file lineaire = {"original version", enfiler_lineaire, defiler_lineaire, taille_lineaire};
+    int resultat = 0;
+
+    for (int profondeur = 0; profondeur <= PROFONDEUR_BANC_FILE; profondeur += PROFONDEUR_BANC_FILE)
+    {
+        file_variable_t file;
+        file_lineaire_t ancienne;
+
+        if (file_variable_initialiser(&file) == -1 || file_lineaire_initialiser(&ancienne) == -1)
+        {
+            printf("Error: Memory allocation failed\n");
+            free(file.file);
+            return -1;
+        }
+
+        if (mesurer_file(&circulaire, &file, profondeur) == -1 || mesurer_file(&lineaire, &ancienne, profondeur) == -1)
+            resultat = -1;
+
+        file_variable_detruire(&file);
+        free(ancienne.file);
+    }
+
+    return resultat;
+}
+
+/**
+ * @brief Tests the containers, then runs the benchmark suite of conteneurs_banc.h and the comparisons
+ *        of the queues and of the heaps.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments, the first one being the option of the program: "--max" followed by the largest
+ *             size measured, "--csv" or "--json" followed by the path of the file to write the results to.
+ * @return 0 on success, -1 if an argument is invalid or a measure failed.
+ */
+int run_queue_and_stack_operations(int argc, char *argv[])
+{
+    long long taille_max = BANC_TAILLE_MAX;
+    const char *csv = NULL, *json = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        char *fin = NULL;
+
+        if (i + 1 < argc && strcmp(argv[i], "--max") == 0)
+        {
+            taille_max = strtoll(argv[++i], &fin, 10);
+            if (*fin != '\0' || taille_max < 10)
+            {
+                printf("Error: --max expects a size of at least 10\n");
+                return -1;
+            }
+        } else if (i + 1 < argc && strcmp(argv[i], "--csv") == 0)
+            csv = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--json") == 0)
+            json = argv[++i];
+        else
+        {
+            printf("Usage: --queue_and_stack_operations [--max SIZE] [--csv FILE] [--json FILE]\n");
+            return -1;
+        }
+    }
+
     test_pile_fixe();
     test_pile_variable();
     test_file_fixe();
     test_file_variable();
-    printf("Hello, World!\n");
-    return 0;
+    test_conteneurs();
+    test_file_spsc();
+    test_file_mpmc();
+    test_file_blocs();
+    test_tas();
+    test_deque_vol();
+    test_ordonnanceur();
+
+    int resultat = banc_conteneurs(taille_max, csv, json);
+    if (banc_file_variable() == -1)
+        resultat = -1;
+    if (banc_file_spsc() == -1)
+        resultat = -1;
+    if (banc_file_mpmc() == -1)
+        resultat = -1;
+    if (banc_tas() == -1)
+        resultat = -1;
+    return resultat;
 }
@@ -5,126 +5,68 @@
 #ifndef R305_QUEUE_AND_STACK_OPERATIONS_H
 #define R305_QUEUE_AND_STACK_OPERATIONS_H
 
+#include "conteneurs.h"
+
 typedef int element_t;
 #define TAILLE_PILE 5
 
-// Une pile de taille fixe
-typedef struct
-{
-    // un tableau d'éléments
-    element_t pile[TAILLE_PILE];
-    // l'indice du dernier élément empilé
-    int sommet;
-} pile_fixe_t;
-
-// Le nombre de nouvelles case qui seront ajoutées
-// dès que la pile sera pleine
+// Une pile de taille fixe :
+//
+// pile_fixe_initialiser vide la pile, pile_fixe_est_vide retourne vrai
+// si la pile est vide, pile_fixe_empiler retourne -1 si la pile est
+// pleine et pile_fixe_depiler retourne -1 si elle est vide
+DEFINIR_PILE_FIXE(pile_fixe, element_t, TAILLE_PILE)
+
+// La taille initiale des piles variables,
+// en dessous de laquelle elles ne rétrécissent pas
 #define PAS_ALLOCATION 5
 
-// Une pile de taille fixe
-typedef struct
-{
-    // un pointeur vers un tableau d'éléments
-    element_t *pile;
-    // l'indice du dernier élément empilé
-    int sommet;
-    // la taille du tableau pile
-    int taille;
-} pile_variable_t;
+// Une pile dont la taille double quand elle est pleine
+// et est divisée par deux quand elle n'est plus remplie qu'au quart :
+//
+// en plus des opérations de la pile fixe, pile_variable_reserver
+// l'agrandit à une taille en dessous de laquelle elle ne rétrécit plus,
+// pile_variable_ajuster la réduit au nombre de ses éléments
+// et pile_variable_detruire libère son tableau
+DEFINIR_PILE(pile_variable, element_t, PAS_ALLOCATION)
 
 #define TAILLE_FILE 5
 
-typedef struct
-{
-    element_t file[TAILLE_FILE];
-    int head;
-    int tail;
-} file_fixe_t;
-
-typedef struct
-{
-    element_t *file;
-    int head;
-    int tail;
-    int taille;
-} file_variable_t;
-
-/// Initialise une pile. La pile
-/// doit être vide après initialisation
-void pile_fixe_initialiser(pile_fixe_t *pile);
-
-/// Retourne vrai si la pile est vide, 0 sinon
-/// (on rappelle qu'en C, 0 est faux, tout le reste est vrai)
-int pile_fixe_est_vide(const pile_fixe_t *pile);
-
-/// Ajoute un élément dans la pile pointée par pile
-///
-/// Retourne 0 si l'élément a pu être ajouté, -1 sinon
-/// (en cas de pile pleine par exemple)
-int pile_fixe_empiler(pile_fixe_t *pile, element_t element);
-
-/// Supprime un élément de la pile et le copie
-/// à l'adresse pointée par p_element.
-///
-/// Retourne 0 en cas de succès, -1 sinon
-/// (si la pile était vide par exemple)
-int pile_fixe_depiler(pile_fixe_t *pile, element_t *p_element);
+// Une file circulaire de taille fixe :
+//
+// file_fixe_initialiser vide la file, file_fixe_est_vide retourne vrai
+// si la file est vide, file_fixe_enfiler retourne -1 si la file est
+// pleine et file_fixe_defiler retourne -1 si elle est vide
+DEFINIR_FILE_FIXE(file_fixe, element_t, TAILLE_FILE)
+
+// Une file circulaire dont la taille double quand elle est pleine
+// et est divisée par deux quand elle n'est plus remplie qu'au quart :
+//
+// en plus des opérations de la file fixe,
+// file_variable_detruire libère son tableau
+DEFINIR_FILE(file_variable, element_t, TAILLE_FILE)
 
 /// Affiche les éléments contenus dans la pile
 void pile_fixe_afficher(const pile_fixe_t *pile);
 
-
-/// Initialise une pile. La pile
-/// doit être vide après initialisation.
-///
-/// Retourne 0 en cas de succès, -1 en cas d'erreur
-/// (l'allocation dynamique a échoué par exemple)
-int pile_variable_initialiser(pile_variable_t *pile);
-
-/// Retourne vrai si la pile est vide, 0 sinon
-/// (on rappelle qu'en C, 0 est faux, tout le reste est vrai)
-int pile_variable_est_vide(const pile_variable_t *pile);
-
-/// Ajoute un élément dans la pile pointée par pile
-///
-/// Retourne 0 si l'élément a pu être ajouté, -1 sinon
-/// (en cas de pile pleine par exemple)
-int pile_variable_empiler(pile_variable_t *pile, element_t element);
-
-/// Supprime un élément de la pile et le copie
-/// à l'adresse pointée par p_element.
-///
-/// Retourne 0 en cas de succès, -1 sinon
-/// (si la pile était vide par exemple)
-int pile_variable_depiler(pile_variable_t *pile, element_t *p_element);
-
 /// Affiche les éléments contenus dans la pile
 void pile_variable_afficher(const pile_variable_t *pile);
 
-/// Detruit la pile
-void pile_variable_detruire(pile_variable_t *pile);
-
-void file_fixe_initialiser(file_fixe_t *file);
-
-int file_fixe_est_vide(const file_fixe_t *file);
-
-int file_fixe_enfiler(file_fixe_t *file, element_t element);
-
-int file_fixe_defiler(file_fixe_t *file, element_t *p_element);
-
+/// Affiche les éléments contenus dans la file
 void file_fixe_afficher(const file_fixe_t *file);
 
-int file_variable_initialiser(file_variable_t *file);
-
-int file_variable_est_vide(const file_variable_t *file);
-
-int file_variable_enfiler(file_variable_t *file, element_t element);
+/// Affiche les éléments contenus dans la file
+void file_variable_afficher(const file_variable_t *file);
 
-int file_variable_defiler(file_variable_t *file, element_t *p_element);
+/// Nombre d'opérations de la mesure comparant file_variable_t
+/// à sa version d'origine, qui ne réutilisait pas le début du tableau
+#define OPERATIONS_BANC_FILE 10000000
 
-void file_variable_afficher(const file_variable_t *file);
+/// Nombre d'éléments présents en permanence dans la file
+/// pendant la mesure en régime établi
+#define PROFONDEUR_BANC_FILE 1000
 
-void file_variable_detruire(file_variable_t *file);
+int banc_file_variable(void);
 
 void test_pile_fixe(void);
 
@@ -134,6 +76,17 @@ void test_file_fixe(void);
 
 void test_file_variable(void);
 
-int run_queue_and_stack_operations(void);
+void test_conteneurs(void);
+
+/**
+ * @brief Tests the containers, then runs the benchmark suite of conteneurs_banc.h and the comparisons
+ *        of the queues and of the heaps.
+ *
+ * @param argc The number of arguments.
+ * @param argv The arguments, the first one being the option of the program: "--max" followed by the largest
+ *             size measured, "--csv" or "--json" followed by the path of the file to write the results to.
+ * @return 0 on success, -1 if an argument is invalid or a measure failed.
+ */
+int run_queue_and_stack_operations(int argc, char *argv[]);
 
 #endif //R305_QUEUE_AND_STACK_OPERATIONS_H
@@ -0,0 +1,217 @@
+/**
+ * @file tas.c
+ * @brief Priority queues of identifiers, as d-ary min-heaps generated by a macro.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <time.h>
+#include "tas.h"
+
+DEFINIR_TAS(tas_binaire, 2)
+
+/**
+ * @brief Displays the entries of the heap in the order of the array, as identifier:priority.
+ */
+void tas_afficher(const tas_t *tas)
+{
+    for (int i = 0; i < tas->nombre; i++)
+        printf("| %d:%lld ", tas->entrees[i].identifiant, tas->entrees[i].priorite);
+    printf("|\n");
+}
+
+/**
+ * @brief Tests the 4-ary heap: order of extraction, decreasing priorities, building at once, invalid
+ *        identifiers, and the same results as a binary heap.
+ */
+void test_tas(void)
+{
+    tas_t tas;
+    tas_binaire_t binaire;
+    int identifiant, autre;
+    long long priorite, precedente;
+
+    assert(tas_initialiser(&tas, 100) == 0);
+    assert(tas_binaire_initialiser(&binaire, 100) == 0);
+
+    // A heap initialized must be empty
+    assert(tas_est_vide(&tas));
+    assert(tas_extraire(&tas, &identifiant, &priorite) == -1);
+
+    // jobs of sizes 30, 10, 50, 20 and 40, biggest first
+    long long tailles[] = {30, 10, 50, 20, 40};
+    for (int i = 0; i < 5; i++)
+        assert(tas_inserer(&tas, i, -tailles[i]) == 0);
+    tas_afficher(&tas);
+    assert(tas_inserer(&tas, 2, 0) == -1);
+    assert(tas_inserer(&tas, 100, 0) == -1);
+    assert(tas_diminuer(&tas, 1, -60) == 0);
+    assert(tas_diminuer(&tas, 1, 0) == -1);
+    assert(tas_diminuer(&tas, 7, 0) == -1);
+    int ordre[] = {1, 2, 4, 0, 3};
+    for (int i = 0; i < 5; i++)
+    {
+        assert(tas_extraire(&tas, &identifiant, &priorite) == 0);
+        assert(identifiant == ordre[i]);
+        assert(!tas_contient(&tas, identifiant));
+    }
+    assert(tas_est_vide(&tas));
+
+    // built at once, then extracted while priorities decrease, the same way by both heaps
+    entree_tas entrees[100];
+    unsigned int alea = 2463534242u;
+    for (int i = 0; i < 100; i++)
+    {
+        alea ^= alea << 13;
+        alea ^= alea >> 17;
+        alea ^= alea << 5;
+        entrees[i] = (entree_tas) {alea % 1000, 99 - i};
+    }
+    assert(tas_construire(&tas, entrees, 100) == 0);
+    assert(tas_binaire_construire(&binaire, entrees, 100) == 0);
+    precedente = -1;
+    while (tas_extraire(&tas, &identifiant, &priorite) == 0)
+    {
+        long long priorite_binaire;
+        assert(tas_binaire_extraire(&binaire, &autre, &priorite_binaire) == 0);
+        assert(priorite == priorite_binaire && priorite >= precedente);
+        precedente = priorite;
+
+        // equal priorities may come out in another order, the identifiers left then differ between the heaps
+        autre = (identifiant * 7 + 3) % 100;
+        if (tas_contient(&tas, autre) && tas_binaire_contient(&binaire, autre))
+        {
+            assert(tas_diminuer(&tas, autre, priorite) == 0);
+            assert(tas_binaire_diminuer(&binaire, autre, priorite) == 0);
+        }
+    }
+    assert(tas_binaire_est_vide(&binaire));
+
+    // a repeated identifier leaves the heap empty
+    entrees[1].identifiant = entrees[0].identifiant;
+    assert(tas_construire(&tas, entrees, 100) == -1);
+    assert(tas_est_vide(&tas));
+    assert(tas_inserer(&tas, entrees[0].identifiant, 0) == 0);
+
+    tas_detruire(&tas);
+    tas_binaire_detruire(&binaire);
+}
+
+/**
+ * @brief Returns the current time of the monotonic clock in seconds.
+ */
+static double maintenant(void)
+{
+    struct timespec temps;
+    clock_gettime(CLOCK_MONOTONIC, &temps);
+    return temps.tv_sec + temps.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Prints the time of a step of the benchmark.
+ */
+static void afficher_mesure(const char *nom, const char *etape, double duree, int resultat)
+{
+    printf("%-14s %-28s %9.2f ms  %s\n", nom, etape, duree * 1e3, resultat == 0 ? "ok" : "OUT OF ORDER");
+}
+
+/**
+ * @brief Defines mesurer_nom, which runs the benchmark on a heap defined with DEFINIR_TAS(nom, ...).
+ */
+#define DEFINIR_BANC_TAS(nom) \
+    static int mesurer_##nom(const char *libelle, const entree_tas *entrees) \
+    { \
+        nom##_t tas; \
+        int identifiant, erreurs = 0, resultat = 0; \
+        long long priorite, precedente; \
+        unsigned int alea = 88172645u; \
+        \
+        if (nom##_initialiser(&tas, ELEMENTS_BANC_TAS) == -1) \
+        { \
+            printf("Error: Memory allocation failed\n"); \
+            return -1; \
+        } \
+        \
+        double debut = maintenant(); \
+        erreurs += nom##_construire(&tas, entrees, ELEMENTS_BANC_TAS) != 0; \
+        afficher_mesure(libelle, "build at once", maintenant() - debut, erreurs); \
+        \
+        debut = maintenant(); \
+        for (precedente = LLONG_MIN; nom##_extraire(&tas, &identifiant, &priorite) == 0; precedente = priorite) \
+            erreurs += priorite < precedente; \
+        afficher_mesure(libelle, "extract all", maintenant() - debut, erreurs); \
+        resultat |= erreurs ? -1 : 0; \
+        \
+        debut = maintenant(); \
+        for (int i = 0; i < ELEMENTS_BANC_TAS; i++) \
+            erreurs += nom##_inserer(&tas, entrees[i].identifiant, entrees[i].priorite) != 0; \
+        afficher_mesure(libelle, "insert one by one", maintenant() - debut, erreurs); \
+        resultat |= erreurs ? -1 : 0; \
+        \
+        /* the priorities decreased stay above the last one extracted, as the distances of a shortest path */ \
+        debut = maintenant(); \
+        for (precedente = LLONG_MIN; nom##_extraire(&tas, &identifiant, &priorite) == 0; precedente = priorite) \
+        { \
+            erreurs += priorite < precedente; \
+            for (int j = 0; j < DIMINUTIONS_BANC_TAS; j++) \
+            { \
+                alea ^= alea << 13; \
+                alea ^= alea >> 17; \
+                alea ^= alea << 5; \
+                int autre = (int) (alea % ELEMENTS_BANC_TAS); \
+                if (nom##_contient(&tas, autre)) \
+                { \
+                    long long actuelle = tas.entrees[tas.positions[autre]].priorite; \
+                    erreurs += nom##_diminuer(&tas, autre, priorite + (actuelle - priorite) / 2) != 0; \
+                } \
+            } \
+        } \
+        afficher_mesure(libelle, "extract and decrease-key", maintenant() - debut, erreurs); \
+        resultat |= erreurs ? -1 : 0; \
+        \
+        nom##_detruire(&tas); \
+        return resultat; \
+    }
+
+DEFINIR_BANC_TAS(tas_binaire)
+DEFINIR_BANC_TAS(tas)
+
+/**
+ * @brief Compares the 4-ary heap with a binary heap on ELEMENTS_BANC_TAS entries: building, inserting,
+ *        extracting, and extracting while decreasing priorities.
+ *
+ * @return 0 on success, -1 if memory allocation failed or an entry came out out of order.
+ */
+int banc_tas(void)
+{
+    entree_tas *entrees = malloc(sizeof(entree_tas) * ELEMENTS_BANC_TAS);
+    unsigned int alea = 2463534242u;
+
+    if (!entrees)
+    {
+        printf("Error: Memory allocation failed\n");
+        return -1;
+    }
+
+    // the identifiers in a shuffled order, with random priorities
+    for (int i = 0; i < ELEMENTS_BANC_TAS; i++)
+        entrees[i].identifiant = i;
+    for (int i = 0; i < ELEMENTS_BANC_TAS; i++)
+    {
+        alea ^= alea << 13;
+        alea ^= alea >> 17;
+        alea ^= alea << 5;
+        int j = i + (int) (alea % (unsigned int) (ELEMENTS_BANC_TAS - i));
+        int identifiant = entrees[j].identifiant;
+        entrees[j].identifiant = entrees[i].identifiant;
+        entrees[i].identifiant = identifiant;
+        entrees[i].priorite = alea;
+    }
+
+    int resultat = mesurer_tas_binaire("binary heap", entrees);
+    if (mesurer_tas("4-ary heap", entrees) == -1)
+        resultat = -1;
+
+    free(entrees);
+    return resultat;
+}
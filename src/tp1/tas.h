@@ -0,0 +1,235 @@
+/**
+ * @file tas.h
+ * @brief Priority queues of identifiers, as d-ary min-heaps generated by a macro.
+ *
+ * A heap holds identifiers from 0 to a bound given at initialisation, each with a priority; the identifier of
+ * smallest priority comes out first, so that jobs are scheduled biggest first with their size negated. Every
+ * identifier is stored at most once and an array gives its position in the heap, so that its priority can be
+ * decreased in O(log n) without searching for it.
+ *
+ * A node has `arite` children, stored next to each other. With four children of 16 bytes and the heap shifted
+ * so that the children of a node start on a cache line, sifting down reads one cache line per level on a tree
+ * half as deep as a binary one; sifting up, as decreasing a priority does, also has half as many levels to
+ * climb. Building a heap from n entries at once sifts down the inner nodes from the last one, in O(n).
+ *
+ * All operations but the display follow the conventions of conteneurs.h: they return 0 on success and -1
+ * when the heap is empty, the identifier is invalid, or memory allocation failed.
+ */
+
+#ifndef R305_TAS_H
+#define R305_TAS_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include "file_spsc.h"
+
+/// Number of children of a node of the heaps of the program
+#define ARITE_TAS 4
+
+/// Number of entries of the benchmark
+#define ELEMENTS_BANC_TAS (1 << 20)
+
+/// Number of priorities decreased after each extraction in the benchmark, as in a shortest path search
+#define DIMINUTIONS_BANC_TAS 2
+
+/// An identifier and its priority
+typedef struct
+{
+    long long priorite;
+    int identifiant;
+} entree_tas;
+
+/**
+ * @brief Defines a min-heap of identifiers whose nodes have `arite` children.
+ *
+ * Defines nom_t and nom_initialiser (for identifiers from 0 to nb_identifiants - 1), nom_est_vide,
+ * nom_contient, nom_inserer, nom_minimum, nom_extraire, nom_diminuer (decreases the priority of an identifier
+ * in the heap), nom_construire (replaces the content of the heap with n entries, in O(n)) and nom_detruire.
+ */
+#define DEFINIR_TAS(nom, arite) \
+    typedef struct \
+    { \
+        entree_tas *base;      /* l'allocation, alignée sur une ligne de cache */ \
+        entree_tas *entrees;   /* le tas, entrees[0] étant le minimum */ \
+        int *positions;        /* l'indice de chaque identifiant dans entrees, -1 s'il est absent */ \
+        int nombre;            /* le nombre d'entrées du tas */ \
+        int nb_identifiants;   /* la borne des identifiants */ \
+    } nom##_t; \
+    \
+    static inline int nom##_initialiser(nom##_t *tas, int nb_identifiants) \
+    { \
+        if (nb_identifiants < 1 || (size_t) nb_identifiants > SIZE_MAX / sizeof(entree_tas) - (arite)) \
+            return -1; \
+        /* the children of node i start at index arite * i + 1, shifted by arite - 1 onto a multiple of arite */ \
+        size_t octets = (nb_identifiants + (arite) - 1) * sizeof(entree_tas); \
+        octets = (octets + TAILLE_LIGNE_CACHE - 1) / TAILLE_LIGNE_CACHE * TAILLE_LIGNE_CACHE; \
+        tas->base = aligned_alloc(TAILLE_LIGNE_CACHE, octets); \
+        tas->positions = malloc(sizeof(int) * nb_identifiants); \
+        if (!tas->base || !tas->positions) \
+        { \
+            free(tas->base); \
+            free(tas->positions); \
+            return -1; \
+        } \
+        tas->entrees = tas->base + (arite) - 1; \
+        for (int i = 0; i < nb_identifiants; i++) \
+            tas->positions[i] = -1; \
+        tas->nombre = 0; \
+        tas->nb_identifiants = nb_identifiants; \
+        return 0; \
+    } \
+    \
+    static inline int nom##_est_vide(const nom##_t *tas) \
+    { \
+        return tas->nombre == 0 ? 1 : 0; \
+    } \
+    \
+    static inline int nom##_contient(const nom##_t *tas, int identifiant) \
+    { \
+        return identifiant >= 0 && identifiant < tas->nb_identifiants && tas->positions[identifiant] != -1; \
+    } \
+    \
+    static inline void nom##_placer(nom##_t *tas, int i, entree_tas entree) \
+    { \
+        tas->entrees[i] = entree; \
+        tas->positions[entree.identifiant] = i; \
+    } \
+    \
+    /* the entry at i moves up while its parent has a larger priority */ \
+    static inline void nom##_monter(nom##_t *tas, int i) \
+    { \
+        entree_tas entree = tas->entrees[i]; \
+        while (i > 0) \
+        { \
+            int parent = (i - 1) / (arite); \
+            if (tas->entrees[parent].priorite <= entree.priorite) \
+                break; \
+            nom##_placer(tas, i, tas->entrees[parent]); \
+            i = parent; \
+        } \
+        nom##_placer(tas, i, entree); \
+    } \
+    \
+    /* the entry at i moves down while one of its children has a smaller priority */ \
+    static inline void nom##_descendre(nom##_t *tas, int i) \
+    { \
+        entree_tas entree = tas->entrees[i]; \
+        for (;;) \
+        { \
+            int premier = (arite) * i + 1; \
+            if (premier >= tas->nombre) \
+                break; \
+            int dernier = premier + (arite) < tas->nombre ? premier + (arite) : tas->nombre; \
+            int plus_petit = premier; \
+            for (int enfant = premier + 1; enfant < dernier; enfant++) \
+            { \
+                if (tas->entrees[enfant].priorite < tas->entrees[plus_petit].priorite) \
+                    plus_petit = enfant; \
+            } \
+            if (tas->entrees[plus_petit].priorite >= entree.priorite) \
+                break; \
+            nom##_placer(tas, i, tas->entrees[plus_petit]); \
+            i = plus_petit; \
+        } \
+        nom##_placer(tas, i, entree); \
+    } \
+    \
+    static inline int nom##_inserer(nom##_t *tas, int identifiant, long long priorite) \
+    { \
+        if (identifiant < 0 || identifiant >= tas->nb_identifiants || tas->positions[identifiant] != -1) \
+            return -1; \
+        nom##_placer(tas, tas->nombre, (entree_tas) {priorite, identifiant}); \
+        nom##_monter(tas, tas->nombre++); \
+        return 0; \
+    } \
+    \
+    static inline int nom##_minimum(const nom##_t *tas, int *p_identifiant, long long *p_priorite) \
+    { \
+        if (nom##_est_vide(tas)) \
+            return -1; \
+        *p_identifiant = tas->entrees[0].identifiant; \
+        *p_priorite = tas->entrees[0].priorite; \
+        return 0; \
+    } \
+    \
+    static inline int nom##_extraire(nom##_t *tas, int *p_identifiant, long long *p_priorite) \
+    { \
+        if (nom##_minimum(tas, p_identifiant, p_priorite) == -1) \
+            return -1; \
+        tas->positions[*p_identifiant] = -1; \
+        if (--tas->nombre > 0) \
+        { \
+            nom##_placer(tas, 0, tas->entrees[tas->nombre]); \
+            nom##_descendre(tas, 0); \
+        } \
+        return 0; \
+    } \
+    \
+    /* fails if the identifier is not in the heap or if the priority would increase */ \
+    static inline int nom##_diminuer(nom##_t *tas, int identifiant, long long priorite) \
+    { \
+        if (!nom##_contient(tas, identifiant)) \
+            return -1; \
+        int i = tas->positions[identifiant]; \
+        if (priorite > tas->entrees[i].priorite) \
+            return -1; \
+        tas->entrees[i].priorite = priorite; \
+        nom##_monter(tas, i); \
+        return 0; \
+    } \
+    \
+    /* the heap is left empty if an identifier is invalid or repeated */ \
+    static inline int nom##_construire(nom##_t *tas, const entree_tas *entrees, int n) \
+    { \
+        for (int i = 0; i < tas->nombre; i++) \
+            tas->positions[tas->entrees[i].identifiant] = -1; \
+        tas->nombre = 0; \
+        if (n < 0 || n > tas->nb_identifiants) \
+            return -1; \
+        for (int i = 0; i < n; i++) \
+        { \
+            if (entrees[i].identifiant < 0 || entrees[i].identifiant >= tas->nb_identifiants \
+                || tas->positions[entrees[i].identifiant] != -1) \
+            { \
+                for (int j = 0; j < i; j++) \
+                    tas->positions[entrees[j].identifiant] = -1; \
+                return -1; \
+            } \
+            nom##_placer(tas, i, entrees[i]); \
+        } \
+        tas->nombre = n; \
+        for (int i = (n - 2) / (arite); n > 1 && i >= 0; i--) \
+            nom##_descendre(tas, i); \
+        return 0; \
+    } \
+    \
+    static inline void nom##_detruire(nom##_t *tas) \
+    { \
+        free(tas->base); \
+        free(tas->positions); \
+        tas->base = NULL; \
+        tas->entrees = NULL; \
+        tas->positions = NULL; \
+        tas->nombre = 0; \
+        tas->nb_identifiants = 0; \
+    }
+
+DEFINIR_TAS(tas, ARITE_TAS)
+
+/**
+ * @brief Displays the entries of the heap in the order of the array, as identifier:priority.
+ */
+void tas_afficher(const tas_t *tas);
+
+void test_tas(void);
+
+/**
+ * @brief Compares the 4-ary heap with a binary heap on ELEMENTS_BANC_TAS entries: building, inserting,
+ *        extracting, and extracting while decreasing priorities.
+ *
+ * @return 0 on success, -1 if memory allocation failed or an entry came out out of order.
+ */
+int banc_tas(void);
+
+#endif //R305_TAS_H
@@ -1,9 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <unistd.h>
+#include <string.h>
 #include <ctype.h>
-
-#define PAS 5
+#include "ligne_commande.h"
 
 void affiche(char ***t)
 {
@@ -21,180 +22,248 @@ void affiche(char ***t)
     }
 }
 
-void libere(char ***t)
+/**********************************************************************
+   Initialise un lecteur de lignes sur un descripteur de fichier
+**********************************************************************/
+void lecteur_initialiser(lecteur_t *lecteur, int fd)
 {
-    int i = 0, j;
+    lecteur->fd = fd;
+    lecteur->tampon = lecteur->stockage;
+    lecteur->debut = 0;
+    lecteur->fin = 0;
+    lecteur->fin_fichier = 0;
+}
 
-    while (t[i] != NULL)
-    {
-        j = 0;
-        while (t[i][j] != NULL)
-        {
-            free(t[i][j]);
-            j++;
-        }
-        free(t[i]);
-        i++;
-    }
-    free(t);
+/**********************************************************************
+   Initialise un lecteur de lignes sur une chaine, lue sans la copier
+**********************************************************************/
+void lecteur_initialiser_chaine(lecteur_t *lecteur, const char *chaine)
+{
+    lecteur->fd = -1;
+    lecteur->tampon = chaine;
+    lecteur->debut = 0;
+    lecteur->fin = strlen(chaine);
+    lecteur->fin_fichier = 1;
 }
 
 /**********************************************************************
    Saisie d'une ligne de taille quelconque terminee par un "newline"
-   retourne NULL en cas d'erreur
+   lit par blocs de TAILLE_TAMPON_LECTEUR octets ; les octets qui
+   suivent la ligne restent dans le tampon pour l'appel suivant
+   retourne NULL en cas d'erreur ou a la fin du fichier
 **********************************************************************/
-char *saisie_ligne_commande()
+char *saisie_ligne_commande(lecteur_t *lecteur, arene_t *arene)
 {
-    int t = PAS, i = 0;
-    char *ligne = (char *) malloc(sizeof(char) * t);
-    char *tmp;
-    int n = 0;
-    while ((n = read(0, ligne + i, sizeof(char) * PAS)) > 0)
+    char *ligne = NULL, *tmp;
+    const char *debut, *newline;
+    size_t longueur = 0, n;
+    ssize_t lus;
+
+    while (1)
     {
-        if (n == PAS && *(ligne + i + PAS - 1) != '\n')
+        if (lecteur->debut == lecteur->fin)
         {
-            t = t + PAS;
-            tmp = (char *) realloc(ligne, sizeof(char) * t);
-            if (tmp == NULL)
+            if (lecteur->fin_fichier) break;
+            lus = read(lecteur->fd, lecteur->stockage, sizeof(lecteur->stockage));
+            if (lus < 0)
             {
+                if (errno == EINTR) continue;
                 perror("erreur iutsh -- lecture de la ligne de commande");
-                free(ligne);
                 return NULL;
             }
-            ligne = tmp;
-            i = i + n;
-        } else
+            if (lus == 0)
+            {
+                lecteur->fin_fichier = 1;
+                break;
+            }
+            lecteur->tampon = lecteur->stockage;
+            lecteur->debut = 0;
+            lecteur->fin = (size_t) lus;
+        }
+
+        debut = lecteur->tampon + lecteur->debut;
+        newline = memchr(debut, '\n', lecteur->fin - lecteur->debut);
+        n = newline ? (size_t) (newline - debut) : lecteur->fin - lecteur->debut;
+
+        // la ligne est la derniere allocation de l'arene : elle s'agrandit sur place
+        tmp = arene_reallouer(arene, ligne, ligne ? longueur + 1 : 0, longueur + n + 1);
+        if (tmp == NULL)
         {
-            *(ligne + i + n - 1) = '\0';
+            perror("erreur iutsh -- lecture de la ligne de commande");
+            return NULL;
+        }
+        ligne = tmp;
+        memcpy(ligne + longueur, debut, n);
+        longueur += n;
+        ligne[longueur] = '\0';
+        lecteur->debut += n;
+
+        if (newline)
+        {
+            lecteur->debut++;
             return ligne;
         }
     }
-    free(ligne);
-    return NULL;
+
+    // la derniere ligne du fichier peut ne pas finir par un "newline"
+    return ligne;
 }
 
 /**********************************************************************
-   Separateur
+   Separateur : caractere qui termine un mot hors des guillemets
 **********************************************************************/
 int separateur(int c)
 {
-    return c == '|' || c == '&' || c == '\0';
+    return c == '|' || c == '&' || c == '<' || c == '>' || c == '\0' || isspace(c);
+}
+
+/**********************************************************************
+   Erreur de syntaxe
+   retourne toujours NULL
+**********************************************************************/
+static char ***erreur_syntaxe(const char *message)
+{
+    fprintf(stderr, "iutsh -- erreur de syntaxe : %s\n", message);
+    return NULL;
 }
 
 /**********************************************************************
    Analyse ligne commande
+   decoupe la ligne sur place en une seule passe : chaque mot est
+   recopie vers le debut de la ligne sans ses guillemets, termine par
+   un '\0', et argv pointe dans la ligne ; seuls les tableaux de
+   pointeurs sont alloues dans l'arene, une fois, a la taille maximale
+   - '...' : texte litteral
+   - "..." : \ n'y echappe que " et \
+   - hors des guillemets, \ echappe le caractere suivant
+   - < fichier, > fichier, >> fichier : redirections de la commande
+   retourne NULL en cas d'erreur (flag vaut alors -1), a la fin du
+   fichier ou pour une ligne vide (flag vaut alors 0)
 **********************************************************************/
-char ***ligne_commande(int *flag, int *nb)
+char ***ligne_commande(lecteur_t *lecteur, arene_t *arene, redirection_t **redirections, int *flag, int *nb)
 {
-    char *ligne = saisie_ligne_commande();
-    char ***tab, ***tmp_tab, **tmp_mot, *tmp_car;
-    int i_tab = 0, t_tab = PAS, t_mot = PAS, t_car = PAS;
-    int i = 0, i_mot, i_car;
+    char *ligne = saisie_ligne_commande(lecteur, arene);
+    char *lecture, *ecriture, *a_terminer = NULL, **cible = NULL;
+    size_t i_mot = 0, i_tab = 0;
+    char c;
 
     *nb = 0;
     *flag = -1;
 
-    if (ligne == NULL) return NULL;
-    while (ligne[i] != '\0' && (ligne[i] == ' ' || ligne[i] == '\t')) i++;
-    if (ligne[i] == '\0')
+    if (ligne == NULL)
     {
-        free(ligne);
+        // la fin du fichier n'est pas une erreur
+        if (lecteur->fin_fichier) *flag = 0;
         return NULL;
     }
-    tab = (char ***) malloc(PAS * sizeof(char **));
-    if (tab == NULL) return NULL;
-    while (ligne[i] != '\0' && ligne[i] != '&')
+
+    // un mot occupe au moins un caractere suivi d'un separateur, une commande au moins un mot :
+    // les mots et les NULL qui terminent les commandes tiennent dans longueur + 2 pointeurs
+    size_t longueur = strlen(ligne);
+    size_t max_commandes = longueur / 2 + 2;
+    char **mots = arene_allouer(arene, sizeof(char *) * (longueur + 2));
+    char ***tab = arene_allouer(arene, sizeof(char **) * max_commandes);
+    redirection_t *redir = arene_allouer(arene, sizeof(redirection_t) * max_commandes);
+    if (mots == NULL || tab == NULL || redir == NULL)
     {
-        if (i_tab == t_tab - 1)
-        {
-            t_tab += PAS;
-            tmp_tab = (char ***) realloc(tab, sizeof(char **) * t_tab);
-            if (tmp_tab == NULL)
-            {
-                tab[i_tab] = NULL;
-                free(ligne);
-                *flag = -1;
-                return tab;
-            }
-            tab = tmp_tab;
-        }
-        if ((tab[i_tab] = (char **) malloc(sizeof(char *) * PAS)) == NULL)
+        perror("erreur iutsh -- analyse de la ligne de commande");
+        return NULL;
+    }
+
+    lecture = ecriture = ligne;
+    tab[0] = mots;
+    redir[0] = (redirection_t) {NULL, NULL, 0};
+    while (1)
+    {
+        while (isspace((unsigned char) *lecture)) lecture++;
+        c = *lecture;
+
+        // le '\0' du mot precedent est ecrit une fois le caractere qui le suit lu, il peut l'ecraser
+        if (a_terminer != NULL)
         {
-            *flag = -1;
-            free(ligne);
-            return tab;
+            *a_terminer = '\0';
+            ecriture = a_terminer + 1;
+            a_terminer = NULL;
         }
 
-        t_mot = PAS;
-        i_mot = 0;
-        while (!separateur(ligne[i]))
+        if (c == '\0' || c == '|' || c == '&')
         {
-            if (i_mot == t_mot - 1)
+            if (cible != NULL) return erreur_syntaxe("redirection sans fichier");
+            if (tab[i_tab] == mots + i_mot)
             {
-                t_mot = t_mot + PAS;
-                /****/
-                tmp_mot = (char **) realloc(tab[i_tab], sizeof(char *) * t_mot);
-                if (tmp_mot == NULL)
+                if (c == '\0' && i_tab == 0 && redir[0].entree == NULL && redir[0].sortie == NULL)
                 {
-                    tab[i_tab][i_mot] = NULL;
-                    tab[i_tab + 1] = NULL;
-                    free(ligne);
-                    *flag = -1;
-                    return tab;
+                    *flag = 0;
+                    return NULL;
                 }
-                tab[i_tab] = tmp_mot;
+                return erreur_syntaxe("commande vide");
             }
-            if ((tab[i_tab][i_mot] = (char *) malloc(sizeof(char) * PAS)) == NULL)
+            mots[i_mot++] = NULL;
+            i_tab++;
+            lecture++;
+            if (c == '|')
             {
-                tab[i_tab + 1] = NULL;
-                *flag = -1;
-                free(ligne);
-                return tab;
+                tab[i_tab] = mots + i_mot;
+                redir[i_tab] = (redirection_t) {NULL, NULL, 0};
+                continue;
             }
-            i_car = 0;
-            while (!isspace(ligne[i]) && !separateur(ligne[i]))
+            if (c == '&')
             {
-                if (i_car == t_car - 1)
-                {
-                    t_car = t_car + PAS;
-                    tmp_car = (char *) realloc(tab[i_tab][i_mot], sizeof(char) * t_car);
-                    if (tmp_car == NULL)
-                    {
-                        tab[i_tab][i_mot][i_car] = '\0';
-                        tab[i_tab][i_mot + 1] = NULL;
-                        tab[i_tab + 1] = NULL;
-                        *flag = -1;
-                        free(ligne);
-                        return tab;
-                    }
-                    tab[i_tab][i_mot] = tmp_car;
-                }
-                tab[i_tab][i_mot][i_car] = ligne[i];
-                i++;
-                i_car++;
+                while (isspace((unsigned char) *lecture)) lecture++;
+                if (*lecture != '\0') return erreur_syntaxe("'&' doit terminer la ligne");
             }
-            tab[i_tab][i_mot][i_car] = '\0';
-            while (isspace(ligne[i])) i++;
-            i_mot++;
+            break;
         }
-        tab[i_tab][i_mot] = NULL;
-        i_tab++;
-        if (ligne[i] == '|')
+
+        if (c == '<' || c == '>')
         {
-            i++;
-            while (isspace(ligne[i])) i++;
-            if (separateur(ligne[i]))
+            if (cible != NULL) return erreur_syntaxe("redirection sans fichier");
+            lecture++;
+            if (c == '<')
             {
-                fprintf(stderr, "iutsh -- erreur de syntaxe\n");
-                free(ligne);
-                return NULL;
+                cible = &redir[i_tab].entree;
+            } else
+            {
+                redir[i_tab].ajout = *lecture == '>';
+                if (redir[i_tab].ajout) lecture++;
+                cible = &redir[i_tab].sortie;
             }
+            continue;
+        }
+
+        // un mot, recopie sur place : il n'est jamais plus long que le texte lu
+        char *mot = ecriture;
+        char guillemet = 0;
+        while ((c = *lecture) != '\0' && (guillemet || !separateur((unsigned char) c)))
+        {
+            lecture++;
+            if (guillemet == '\'')
+            {
+                if (c == '\'') guillemet = 0;
+                else *ecriture++ = c;
+            } else if (c == '\\' && *lecture != '\0' && (!guillemet || *lecture == '"' || *lecture == '\\'))
+                *ecriture++ = *lecture++;
+            else if (c == '"' && guillemet)
+                guillemet = 0;
+            else if ((c == '"' || c == '\'') && !guillemet)
+                guillemet = c;
+            else
+                *ecriture++ = c;
         }
+        if (guillemet) return erreur_syntaxe("guillemet non ferme");
+        a_terminer = ecriture;
+
+        if (cible != NULL)
+        {
+            *cible = mot;
+            cible = NULL;
+        } else
+            mots[i_mot++] = mot;
     }
+
     tab[i_tab] = NULL;
-    if (ligne[i] == '\0') *flag = 0;
-    else *flag = 1;
-    free(ligne);
-    *nb = i_tab;
+    *flag = c == '&' ? 1 : 0;
+    *nb = (int) i_tab;
+    if (redirections != NULL) *redirections = redir;
     return tab;
 }
@@ -1,10 +1,59 @@
 #ifndef LIGNE_COMMANDE_H
 #define LIGNE_COMMANDE_H
 
-char ***ligne_commande(int *flag, int *nb);
+#include "../commun/arene.h"
 
-void affiche(char ***t);
+/// Size of the buffer of a line reader, the number of bytes asked for by each read
+#define TAILLE_TAMPON_LECTEUR 4096
+
+/// A reader of lines from a file descriptor or a string, keeping the bytes read after a line for the next ones
+typedef struct
+{
+    int fd;                 ///< the file descriptor read, -1 for a string
+    const char *tampon;     ///< the bytes not returned yet: stockage, or the string
+    size_t debut;           ///< index of the first byte not returned yet in tampon
+    size_t fin;             ///< number of bytes in tampon
+    int fin_fichier;        ///< 1 once read has reached the end of the file
+    char stockage[TAILLE_TAMPON_LECTEUR];
+} lecteur_t;
+
+/// The redirections of a command, NULL when absent
+typedef struct
+{
+    char *entree;   ///< file read as standard input, after '<'
+    char *sortie;   ///< file written as standard output, after '>' or '>>'
+    int ajout;      ///< 1 if the output is appended to the file ('>>'), 0 if it is truncated ('>')
+} redirection_t;
+
+/**
+ * @brief Initialises a line reader on a file descriptor.
+ */
+void lecteur_initialiser(lecteur_t *lecteur, int fd);
 
-void libere(char ***t);
+/**
+ * @brief Initialises a line reader on the lines of a string, which must outlive the reader.
+ */
+void lecteur_initialiser_chaine(lecteur_t *lecteur, const char *chaine);
+
+/**
+ * @brief Reads a command line and splits it into commands, their arguments and their redirections.
+ *
+ * The line is split in place: the words are unquoted and ended with NULs in the line itself, the arrays point
+ * into it. Single quotes keep their text as is, double quotes let a backslash escape '"' and '\\', and a
+ * backslash outside quotes escapes any character. The line and the arrays are allocated from the arena, and
+ * are released by resetting it.
+ *
+ * @param lecteur The reader the line is read from; lecteur->fin_fichier is set once the input is exhausted.
+ * @param arene The arena receiving the line.
+ * @param redirections Receives the redirections of each command, in the order of the commands; may be NULL.
+ * @param flag Receives 1 if the line ends with '&', 0 otherwise, for an empty line or at the end of the input,
+ *             -1 on error or syntax error.
+ * @param nb Receives the number of commands.
+ * @return The commands, an array ending with NULL of argv arrays ending with NULL, or NULL on error, syntax
+ *         error, at the end of the input or for an empty line.
+ */
+char ***ligne_commande(lecteur_t *lecteur, arene_t *arene, redirection_t **redirections, int *flag, int *nb);
+
+void affiche(char ***t);
 
 #endif //LIGNE_COMMANDE_H
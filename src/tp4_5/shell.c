@@ -2,15 +2,27 @@
 // Created by Lilith Camplin on 28/11/2023.
 //
 
+// F_SETPIPE_SZ is an extension of Linux
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <pwd.h>
+#include <spawn.h>
+#include <signal.h>
+#include <termios.h>
 #include "shell.h"
 #include "ligne_commande.h"
+#include "shell_banc.h"
+
+extern char **environ;
 
 #if defined(__linux__)
 
@@ -88,15 +100,88 @@ void replace_home_with_tilde(char *currentDirectory)
 }
 
 /**
- * Executes provided command line
+ * Opens a file of a redirection, reporting the error if it cannot be opened
+ * @param file The file name
+ * @param flags The flags of open
+ * @return The file descriptor, -1 on error
+ */
+static int open_redirection(const char *file, int const flags)
+{
+    // the other commands of the pipeline must not inherit it
+    int const fd = open(file, flags | O_CLOEXEC, 0644);
+    if (fd == -1)
+        perror(file);
+    return fd;
+}
+
+/**
+ * Creates the pipe between two commands of a pipeline
+ * @param p Receives the read and write ends
+ * @param pipeSize The size of the buffer of the pipe in bytes, 0 for the default one
+ * @return 0 on success, -1 on error
+ */
+static int open_pipe(int p[2], int const pipeSize)
+{
+    if (pipe(p) == -1)
+    {
+        perror("pipe");
+        return -1;
+    }
+
+    // every command runs at the same time: a command holding the ends of another pipe would keep it from ending
+    fcntl(p[0], F_SETFD, FD_CLOEXEC);
+    fcntl(p[1], F_SETFD, FD_CLOEXEC);
+
+#ifdef F_SETPIPE_SZ
+    // the size has been checked by run_shell, the default one is kept if it is refused now
+    if (pipeSize > 0)
+        fcntl(p[1], F_SETPIPE_SZ, pipeSize);
+#else
+    (void) pipeSize;
+#endif
+    return 0;
+}
+
+/**
+ * Gives the terminal to a process group, the shell ignoring the SIGTTOU it receives when it is not in the
+ * foreground anymore
+ * @param pgid The process group
+ */
+static void give_terminal(pid_t const pgid)
+{
+    sigset_t ttou, previous;
+    sigemptyset(&ttou);
+    sigaddset(&ttou, SIGTTOU);
+    sigprocmask(SIG_BLOCK, &ttou, &previous);
+    tcsetpgrp(0, pgid);
+    sigprocmask(SIG_SETMASK, &previous, NULL);
+}
+
+/**
+ * Executes provided command line: every command of the pipeline is launched, then they are all waited for
  * @param commands The command to execute
+ * @param redirections The redirections of each command
  * @param commandCount The number of command
  * @param backgroundFlag Flag to execute in background
+ * @param interactive 1 if the command line was typed at the prompt, which allows job control
+ * @param pipeSize The size of the buffer of the pipes in bytes, 0 for the default one
+ * @return The exit status of the last command, 0 if it runs in background
  */
-void execute_command_line(char ***const commands, int const commandCount, int const backgroundFlag)
+int execute_command_line(char ***const commands, const redirection_t *redirections, int const commandCount,
+                         int const backgroundFlag, int const interactive, int const pipeSize)
 {
     int in = 0;
     int out;
+    int result = 0;
+    pid_t pids[commandCount];
+    int launched = 0;
+    pid_t last = -1;
+
+    // at the prompt of a terminal of which the shell is in the foreground, the pipeline gets its own process group,
+    // which gets the terminal unless it runs in background ; otherwise, as for -c and scripts, its commands stay in
+    // the group of the shell
+    int const jobControl = interactive && isatty(0) && tcgetpgrp(0) == getpgrp();
+    pid_t pgid = jobControl ? 0 : -1;
 
     for (int i = 0; i < commandCount; i++)
     {
@@ -105,53 +190,179 @@ void execute_command_line(char ***const commands, int const commandCount, int co
         {
             if (commands[i][1] != NULL)
             {
-                if (chdir(commands[i][1]) != 0)
+                result = chdir(commands[i][1]) == 0 ? 0 : 1;
+                if (result != 0)
                 {
                     perror("chdir() error");
                 }
             } else
             {
-                chdir(getenv("HOME")); // aller au répertoire d'accueil
+                result = chdir(getenv("HOME")) == 0 ? 0 : 1; // aller au répertoire d'accueil
             }
+            last = -1;
             continue;
         }
 
-        int p[2];
-        pipe(p);
+        int p[2] = {-1, -1};
 
         if (i == commandCount - 1)
         {
             out = 1;
+        } else if (open_pipe(p, pipeSize) == -1)
+        {
+            break;
         } else
         {
             out = p[1];
         }
 
-        pid_t const pid = launch_command(in, out, commands[i][0], commands[i]);
+        // les redirections remplacent le tube ; le tube est quand même créé pour que la commande suivante lise une fin
+        // de fichier
+        int input = in, output = out;
+        if (redirections[i].entree)
+            input = open_redirection(redirections[i].entree, O_RDONLY);
+        if (redirections[i].sortie)
+            output = open_redirection(redirections[i].sortie,
+                                      O_WRONLY | O_CREAT | (redirections[i].ajout ? O_APPEND : O_TRUNC));
+
+        pid_t pid = -1;
+        if (input != -1 && output != -1)
+            pid = launch_command(input, output, commands[i][0], commands[i], pgid);
 
         if (in != 0) close(in);
         if (out != 1) close(out);
+        if (input != in && input != -1) close(input);
+        if (output != out && output != -1) close(output);
 
         in = p[0];
 
-        if (!backgroundFlag)
+        result = pid > 0 ? 0 : 1;
+        last = pid;
+        if (pid > 0)
         {
-            // attendre la fin de l'exécution de la commande si elle n'est pas exécutée en arrière-plan
-            int status;
-            waitpid(pid, &status, 0);
+            pids[launched++] = pid;
+            if (pgid == 0)
+            {
+                // the first command leads the group of the pipeline
+                pgid = pid;
+                if (!backgroundFlag)
+                    give_terminal(pgid);
+            }
         }
     }
+
+    if (in > 0) close(in);
+
+    if (!backgroundFlag)
+    {
+        // attendre la fin de toutes les commandes si elles ne sont pas exécutées en arrière-plan
+        for (int i = 0; i < launched; i++)
+        {
+            int status = 0;
+            pid_t waited;
+            while (1)
+            {
+                waited = waitpid(pids[i], &status, jobControl ? WUNTRACED : 0);
+                if (waited == -1 && errno == EINTR)
+                    continue;
+                // a command that used the terminal before the group got it was stopped, it can use it now ; the
+                // other stops, as the one of Ctrl-Z, are left to the user
+                if (waited == pids[i] && WIFSTOPPED(status)
+                    && (WSTOPSIG(status) == SIGTTIN || WSTOPSIG(status) == SIGTTOU))
+                {
+                    kill(-pgid, SIGCONT);
+                    continue;
+                }
+                break;
+            }
+            if (waited != pids[i])
+            {
+                perror("waitpid");
+                continue;
+            }
+            if (pids[i] == last)
+            {
+                if (WIFEXITED(status))
+                    result = WEXITSTATUS(status);
+                else if (WIFSIGNALED(status))
+                    result = 128 + WTERMSIG(status);
+                else
+                    result = 128 + WSTOPSIG(status);
+            }
+        }
+        if (pgid > 0)
+            give_terminal(getpgrp());
+    }
+    return result;
+}
+
+/**
+ * Creates a new process and executes a command, with posix_spawn: glibc creates the process with
+ * CLONE_VFORK, sharing the memory of the shell instead of copying its page tables as fork does.
+ * @param in File descriptor for stdin
+ * @param out File descriptor for stdout
+ * @param command The command to be executed
+ * @param argv The arguments for the command
+ * @param pgid The process group to join, 0 to lead a new one, -1 to stay in the one of the shell
+ * @return Process ID of created process, -1 if it cannot be created or the command cannot be executed
+ */
+int launch_command(int const in, int const out, const char *command, char **argv, pid_t const pgid)
+{
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attributes;
+    pid_t pid;
+    int erreur = posix_spawn_file_actions_init(&actions);
+
+    if (erreur == 0)
+        erreur = posix_spawnattr_init(&attributes);
+    if (erreur != 0)
+    {
+        fprintf(stderr, "%s: %s\n", command, strerror(erreur));
+        return -1;
+    }
+
+    // les redirections que le fils de launch_command_fork fait avant execvp
+    if (in != 0)
+    {
+        erreur = posix_spawn_file_actions_adddup2(&actions, in, 0);
+        if (erreur == 0)
+            erreur = posix_spawn_file_actions_addclose(&actions, in);
+    }
+    if (erreur == 0 && out != 1)
+    {
+        erreur = posix_spawn_file_actions_adddup2(&actions, out, 1);
+        if (erreur == 0)
+            erreur = posix_spawn_file_actions_addclose(&actions, out);
+    }
+    if (erreur == 0 && pgid >= 0)
+    {
+        erreur = posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+        if (erreur == 0)
+            erreur = posix_spawnattr_setpgroup(&attributes, pgid);
+    }
+    if (erreur == 0)
+        erreur = posix_spawnp(&pid, command, &actions, &attributes, argv, environ);
+
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&actions);
+    if (erreur != 0)
+    {
+        fprintf(stderr, "%s: %s\n", command, strerror(erreur));
+        return -1;
+    }
+    return pid;
 }
 
 /**
- * Creates a new process and executes a command.
+ * Creates a new process by fork and executes a command.
  * @param in File descriptor for stdin
  * @param out File descriptor for stdout
  * @param command The command to be executed
  * @param argv The arguments for the command
+ * @param pgid The process group to join, 0 to lead a new one, -1 to stay in the one of the shell
  * @return Process ID of created process
  */
-int launch_command(int const in, int const out, const char *command, char **argv)
+int launch_command_fork(int const in, int const out, const char *command, char **argv, pid_t const pgid)
 {
     pid_t const pid = fork(); // on crée un nouveau processus par clonage du processus courant
 
@@ -163,6 +374,9 @@ int launch_command(int const in, int const out, const char *command, char **argv
     if (pid == 0)
     {
         // ici on se trouve dans le processus fils
+        if (pgid >= 0)
+            setpgid(0, pgid);
+
         if (in != 0)
         {
             // vérifier s'il faut rediriger l'entrée standard
@@ -182,39 +396,154 @@ int launch_command(int const in, int const out, const char *command, char **argv
         _exit(1);
     }
 
+    // le père aussi, pour que le groupe existe avant que le fils ne soit élu
+    if (pgid >= 0)
+        setpgid(pid, pgid == 0 ? pid : pgid);
+
     return pid; // retourne le PID du processus créé
 }
 
 /**
- * Main run function for the shell command
+ * Executes the command lines of a reader until the end of its input or an "exit" command
+ * @param lecteur The reader of the command lines
+ * @param interactive 1 to display the prompt before each line, 0 to run the lines as a script
+ * @param pipeSize The size of the buffer of the pipes in bytes, 0 for the default one
+ * @return The exit status of the last command line, 2 if a line of a script cannot be read or parsed
  */
-void run_shell()
+static int run_command_lines(lecteur_t *lecteur, int const interactive, int const pipeSize)
 {
-    int flag, nb;
+    int flag, nb, result = 0;
+    redirection_t *redirections;
+    arene_t arene;
+
+    arene_initialiser(&arene, 0);
 
     while (1)
     {
+        // The commands run in background that have ended are reaped
+        while (waitpid(-1, NULL, WNOHANG) > 0);
+
         // Loop forever until we hit a break statement
-        display_prompt();
+        if (interactive)
+            display_prompt();
 
-        char ***commands = ligne_commande(&flag, &nb);
+        // The line of the previous prompt is released, its memory is reused
+        arene_reinitialiser(&arene);
+        char ***commands = ligne_commande(lecteur, &arene, &redirections, &flag, &nb);
 
-        // Check if ligne_commande returned NULL (error or no command entered)
+        // Check if ligne_commande returned NULL (end of input, error or no command entered)
         if (commands == NULL)
         {
-            printf("An error occurred while reading commands.\n");
+            if (flag == -1)
+            {
+                printf("An error occurred while reading commands.\n");
+                result = 2;
+                // a script stops at its first error, as POSIX shells do ; only the prompt goes on
+                if (!interactive)
+                    break;
+                continue;
+            }
+            if (lecteur->fin_fichier && lecteur->debut == lecteur->fin)
+                break;
             continue;
         }
 
         // If the first word of the first command is "exit", exit the shell loop
-        if (commands[0][0] && strcmp(commands[0][0], "exit") == 0)
-        {
-            libere(commands); // Free the memory allocated by ligne_commande
+        if (strcmp(commands[0][0], "exit") == 0)
             break;
-        }
 
-        execute_command_line(commands, nb, flag == 1 ? 1 : 0);
+        result = execute_command_line(commands, redirections, nb, flag == 1 ? 1 : 0, interactive, pipeSize);
+    }
+
+    arene_detruire(&arene); // Free the memory of the command lines
+    return result;
+}
+
+/**
+ * Reads the size of the pipe buffers given after OPTION_TAILLE_TUBE and checks that a pipe accepts it
+ * @param argument The size in bytes
+ * @return The size, -1 if it is invalid or refused
+ */
+static int read_pipe_size(const char *argument)
+{
+    char *end = NULL;
+    long const size = strtol(argument, &end, 10);
 
-        libere(commands); // Free the memory allocated by ligne_commande
+    if (*end != '\0' || size < 1 || size > INT_MAX)
+    {
+        printf("Error: %s expects a size in bytes\n", OPTION_TAILLE_TUBE);
+        return -1;
     }
+#ifdef F_SETPIPE_SZ
+    int p[2];
+    if (pipe(p) == -1)
+    {
+        perror("pipe");
+        return -1;
+    }
+    int const accepted = fcntl(p[1], F_SETPIPE_SZ, (int) size);
+    if (accepted == -1)
+        perror(OPTION_TAILLE_TUBE);
+    close(p[0]);
+    close(p[1]);
+    return accepted == -1 ? -1 : (int) size;
+#else
+    printf("Error: %s is not supported on this system\n", OPTION_TAILLE_TUBE);
+    return -1;
+#endif
+}
+
+/**
+ * Main run function for the shell command: interactive without arguments, otherwise runs the commands given
+ * with -c or the lines of a script, without a prompt
+ * @param argc The number of arguments, the first one being the option of the shell
+ * @param argv The arguments
+ * @return The exit status of the last command line, -1 if the arguments are invalid or the script cannot be read
+ */
+int run_shell(int argc, char *argv[])
+{
+    lecteur_t lecteur;
+    int fd = -1, pipeSize = 0;
+
+    if (argc >= 2 && strcmp(argv[1], OPTION_BANC_SHELL) == 0)
+        return run_shell_banc(argc - 1, argv + 1);
+
+    if (argc >= 3 && strcmp(argv[1], OPTION_TAILLE_TUBE) == 0)
+    {
+        pipeSize = read_pipe_size(argv[2]);
+        if (pipeSize == -1)
+            return -1;
+        // the option and its size are skipped, the other arguments start at argv[1] again
+        argc -= 2;
+        argv += 2;
+    }
+
+    if (argc == 3 && strcmp(argv[1], "-c") == 0)
+    {
+        lecteur_initialiser_chaine(&lecteur, argv[2]);
+    } else if (argc == 2 && argv[1][0] != '-')
+    {
+        // the commands must not inherit the script
+        fd = open(argv[1], O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+        {
+            perror(argv[1]);
+            return -1;
+        }
+        lecteur_initialiser(&lecteur, fd);
+    } else if (argc <= 1)
+    {
+        lecteur_initialiser(&lecteur, 0);
+    } else
+    {
+        printf("Usage: --shell [%s SIZE] [-c COMMANDS | SCRIPT] | --shell %s [LAUNCHES]\n", OPTION_TAILLE_TUBE,
+               OPTION_BANC_SHELL);
+        return -1;
+    }
+
+    // the prompt is only displayed to someone typing the commands, not to a script piped in
+    int const result = run_command_lines(&lecteur, argc <= 1 && isatty(0), pipeSize);
+
+    if (fd != -1) close(fd);
+    return result;
 }
@@ -6,6 +6,11 @@
 #define SHELL_H
 
 #include <unistd.h>
+#include <sys/types.h>
+#include "ligne_commande.h"
+
+/// Argument of --shell, followed by a size in bytes, setting the size of the buffer of the pipes of the pipelines
+#define OPTION_TAILLE_TUBE "--pipe-size"
 
 /**
  * @function display_prompt
@@ -23,32 +28,63 @@ void replace_home_with_tilde(char *currentDirectory);
 
 /**
  * @function execute_command_line
- * Executes each command in a given array of commands.
- * If the background flag is set, the commands are run in the background.
+ * Executes each command in a given array of commands, all at the same time, connected by pipes.
+ * Every command is launched, then they are all waited for unless the background flag is set.
+ * At the prompt, when the shell is in the foreground of a terminal, the commands get a process group of their
+ * own, which gets the terminal while they run in the foreground.
  *
  * @param commands 3D array containing each command to execute.
+ * @param redirections The redirections of each command.
  * @param commandCount Array size (i.e., number of commands).
  * @param backgroundFlag 1 if commands are to be run in background, 0 otherwise.
+ * @param interactive 1 if the command line was typed at the prompt, which allows job control, 0 otherwise.
+ * @param pipeSize The size of the buffer of the pipes in bytes, 0 for the default one.
+ * @return The exit status of the last command, 0 if it runs in background.
  */
-void execute_command_line(char ***commands, int commandCount, int backgroundFlag);
+int execute_command_line(char ***commands, const redirection_t *redirections, int commandCount, int backgroundFlag,
+                         int interactive, int pipeSize);
 
 /**
  * @function launch_command
- * Launches a given command by creating a new process.
+ * Launches a given command by creating a new process with posix_spawn, which does not copy the memory of the
+ * shell.
+ *
+ * @param in File descriptor for standard input.
+ * @param out File descriptor for standard output.
+ * @param command String containing the command to be executed.
+ * @param argv Array of arguments for the command.
+ * @param pgid The process group to join, 0 to lead a new one, -1 to stay in the one of the shell.
+ * @return The process ID of the newly created process, -1 if it cannot be created or the command cannot be
+ *         executed.
+ */
+int launch_command(int in, int out, const char *command, char **argv, pid_t pgid);
+
+/**
+ * @function launch_command_fork
+ * Launches a given command by creating a new process with fork, then execvp.
  *
  * @param in File descriptor for standard input.
  * @param out File descriptor for standard output.
  * @param command String containing the command to be executed.
  * @param argv Array of arguments for the command.
- * @return The process ID of the newly created process.
+ * @param pgid The process group to join, 0 to lead a new one, -1 to stay in the one of the shell.
+ * @return The process ID of the newly created process, -1 if it cannot be created.
  */
-int launch_command(int in, int out, const char *command, char **argv);
+int launch_command_fork(int in, int out, const char *command, char **argv, pid_t pgid);
 
 /**
  * @function run_shell
- * Starts the shell program, executing until an "exit" command is entered.
+ * Starts the shell program, executing until an "exit" command is entered or the input ends.
+ * Without arguments, the shell reads its commands from standard input, with a prompt if it is a terminal.
+ * With "-c COMMANDS" or "SCRIPT", it runs the lines of the string or of the file, without a prompt.
+ * OPTION_TAILLE_TUBE SIZE, before them, sets the size of the buffer of the pipes.
+ * With OPTION_BANC_SHELL, it runs the benchmark of shell_banc.h instead.
  * This is the main function from which all other shell functionalities are triggered.
+ *
+ * @param argc The number of arguments, the first one being the option of the shell.
+ * @param argv The arguments.
+ * @return The exit status of the last command line, -1 if the arguments are invalid or the script cannot be read.
  */
-void run_shell();
+int run_shell(int argc, char *argv[]);
 
 #endif //SHELL_H
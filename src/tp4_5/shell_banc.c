@@ -0,0 +1,125 @@
+/**
+ * @file shell_banc.c
+ * @brief Benchmark of the latency of launching a command, with fork and execvp or with posix_spawn.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "shell.h"
+#include "shell_banc.h"
+
+/// A way of launching a command
+typedef struct
+{
+    const char *nom;
+    int (*lancer)(int in, int out, const char *command, char **argv, pid_t pgid);
+} lancement_banc;
+
+static const lancement_banc lancements[] = {
+        {"fork + execvp", launch_command_fork},
+        {"posix_spawn",   launch_command},
+};
+
+/**
+ * @brief Returns the current time of the monotonic clock in seconds.
+ */
+static double maintenant(void)
+{
+    struct timespec temps;
+    clock_gettime(CLOCK_MONOTONIC, &temps);
+    return temps.tv_sec + temps.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Compares two durations, for qsort.
+ */
+static int comparer_durees(const void *a, const void *b)
+{
+    double const x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Launches /bin/true n times one way, waiting for each launch, and prints the latencies.
+ *
+ * @param durees Array of n durations, used as scratch.
+ * @return 0 on success, -1 if a launch failed.
+ */
+static int mesurer(const char *memoire, const lancement_banc *lancement, double *durees, int n)
+{
+    char *argv[] = {"true", NULL};
+    double total = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        int status;
+        double const debut = maintenant();
+        pid_t const pid = lancement->lancer(0, 1, "/bin/true", argv, -1);
+        if (pid <= 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            printf("Error: Cannot launch /bin/true with %s\n", lancement->nom);
+            return -1;
+        }
+        durees[i] = maintenant() - debut;
+        total += durees[i];
+    }
+
+    qsort(durees, n, sizeof(double), comparer_durees);
+    printf("%-10s %-14s %10.1f %10.1f %10.1f\n", memoire, lancement->nom, total / n * 1e6, durees[n / 2] * 1e6,
+           durees[(int) (n * 0.99)] * 1e6);
+    return 0;
+}
+
+int run_shell_banc(int argc, char *argv[])
+{
+    int n = LANCEMENTS_BANC_SHELL;
+    int resultat = 0;
+
+    if (argc > 1)
+    {
+        char *fin = NULL;
+        n = (int) strtol(argv[1], &fin, 10);
+        if (*fin != '\0' || n < 1)
+        {
+            printf("Usage: --shell %s [LAUNCHES]\n", OPTION_BANC_SHELL);
+            return -1;
+        }
+    }
+
+    double *durees = malloc(sizeof(double) * n);
+    if (!durees)
+    {
+        printf("Error: Memory allocation failed\n");
+        return -1;
+    }
+
+    printf("%-10s %-14s %10s %10s %10s\n", "mapped", "launch", "mean (us)", "p50 (us)", "p99 (us)");
+    for (size_t i = 0; i < sizeof(lancements) / sizeof(lancements[0]); i++)
+        resultat |= mesurer("0 MiB", &lancements[i], durees, n);
+
+    // every page touched, so that fork has page tables to copy
+    char *tampon = malloc(MEMOIRE_BANC_SHELL);
+    if (!tampon)
+    {
+        printf("Error: Memory allocation failed\n");
+        free(durees);
+        return -1;
+    }
+    memset(tampon, 1, MEMOIRE_BANC_SHELL);
+
+    char memoire[32];
+    sprintf(memoire, "%zu MiB", MEMOIRE_BANC_SHELL >> 20);
+    for (size_t i = 0; i < sizeof(lancements) / sizeof(lancements[0]); i++)
+        resultat |= mesurer(memoire, &lancements[i], durees, n);
+
+    // read back so that the buffer is not optimised away
+    if (tampon[MEMOIRE_BANC_SHELL - 1] != 1)
+        resultat = -1;
+    free(tampon);
+    free(durees);
+    return resultat;
+}
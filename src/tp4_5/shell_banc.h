@@ -0,0 +1,34 @@
+/**
+ * @file shell_banc.h
+ * @brief Benchmark of the latency of launching a command, with fork and execvp or with posix_spawn.
+ *
+ * fork copies the page tables of the shell, so its cost grows with the memory the shell has mapped, while
+ * posix_spawn creates the child with CLONE_VFORK and shares that memory until the command is executed. Each
+ * way launches /bin/true many times and waits for it, first from the shell as is, then with a large buffer
+ * mapped and touched, and the latency of a launch is reported.
+ */
+
+#ifndef R305_SHELL_BANC_H
+#define R305_SHELL_BANC_H
+
+#include <stddef.h>
+
+/// First argument of --shell selecting the benchmark, optionally followed by the number of launches
+#define OPTION_BANC_SHELL "--bench"
+
+/// Default number of launches of each case
+#define LANCEMENTS_BANC_SHELL 1000
+
+/// Size of the buffer mapped and touched before the second round, as the buffers of a large shell
+#define MEMOIRE_BANC_SHELL ((size_t) 512 << 20)
+
+/**
+ * @brief Runs the benchmark.
+ *
+ * @param argc The number of arguments, OPTION_BANC_SHELL included.
+ * @param argv The arguments, starting with OPTION_BANC_SHELL, optionally followed by the number of launches.
+ * @return 0 on success, -1 if the arguments are invalid, memory allocation failed or a launch failed.
+ */
+int run_shell_banc(int argc, char *argv[]);
+
+#endif //R305_SHELL_BANC_H
@@ -0,0 +1,548 @@
+/**
+ * @file bmp_banc.c
+ * @brief Benchmark and golden-image check of the filters of the BMP modification tool.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "bmp_banc.h"
+#include "bmp_flux.h"
+#include "bmp_lot.h"
+
+/// The filters benchmarked, one of each kind: table, cross-channel, threaded, vectorised, geometric
+static const cas_banc cas[] = {
+        {"-n",                                    1},
+        {"-r -b",                                 1},
+        {"--gamma 2.2 --contrast 1.3 --mask rg",  1},
+        {"--threshold 128 -n",                    1},
+        {"--crop 10,20,300,200 -s",               1},
+        {"--autolevels",                          0},
+        {"-g 4",                                  0},
+        {"-S",                                    0},
+        {"--resize 320x240",                      0},
+        {"--resize 0x100:lanczos",                0},
+        {"--rotate 90",                           0},
+        {"--rotate 270 --flip-v",                 0},
+        {"--flip-h --rotate 180",                 0},
+};
+
+/// Synthetic images of several megapixels
+static const synthetique_banc synthetiques[] = {
+        {"synthetic-24bit-12mp", 4000, 3000, 24},
+        {"synthetic-32bit-8mp",  3264, 2448, 32},
+        {"synthetic-8bit-3mp",   2000, 1500, 8},
+        {"synthetic-16bit-3mp",  2000, 1500, 16},
+};
+
+/// Test images of the repository, one per row padding
+static const char *const images[] = {"test24-pad0.bmp", "test24-pad1.bmp", "test24-pad2.bmp", "test24-pad3.bmp"};
+
+/// Hashes of the outputs, checked against the reference filters when they were recorded
+static const reference_banc references[] = {
+        {"test24-pad0.bmp",       "-n",                                    0x98347076e77e6b51ULL},
+        {"test24-pad0.bmp",       "-r -b",                                 0xa1cd65888e2edb63ULL},
+        {"test24-pad0.bmp",       "--gamma 2.2 --contrast 1.3 --mask rg",  0x12784719862d8900ULL},
+        {"test24-pad0.bmp",       "--threshold 128 -n",                    0x327ee292f481a0b4ULL},
+        {"test24-pad0.bmp",       "--crop 10,20,300,200 -s",               0xdc53dba4a49e2c49ULL},
+        {"test24-pad0.bmp",       "--autolevels",                          0x16dfd994b4dbc690ULL},
+        {"test24-pad0.bmp",       "-g 4",                                  0x0fce21c7c042a7f4ULL},
+        {"test24-pad0.bmp",       "-S",                                    0x3c32f9c638f3c1f4ULL},
+        {"test24-pad0.bmp",       "--resize 320x240",                      0xf1e61338e9194d49ULL},
+        {"test24-pad0.bmp",       "--resize 0x100:lanczos",                0x7bbc50a78730a5d1ULL},
+        {"test24-pad0.bmp",       "--rotate 90",                           0xa12cda4362e014afULL},
+        {"test24-pad0.bmp",       "--rotate 270 --flip-v",                 0x95ef219859c705f7ULL},
+        {"test24-pad0.bmp",       "--flip-h --rotate 180",                 0xefc5b58ba01c8c99ULL},
+        {"test24-pad1.bmp",       "-n",                                    0x0f5f6a27cf577309ULL},
+        {"test24-pad1.bmp",       "-r -b",                                 0x03858c4b83917881ULL},
+        {"test24-pad1.bmp",       "--gamma 2.2 --contrast 1.3 --mask rg",  0x7caeed53d98b9d9bULL},
+        {"test24-pad1.bmp",       "--threshold 128 -n",                    0x3af2325527b74764ULL},
+        {"test24-pad1.bmp",       "--crop 10,20,300,200 -s",               0xd6df10ccd3591a71ULL},
+        {"test24-pad1.bmp",       "--autolevels",                          0x60cfef9eec7c2609ULL},
+        {"test24-pad1.bmp",       "-g 4",                                  0x507699cb1541b587ULL},
+        {"test24-pad1.bmp",       "-S",                                    0xf2889ea165ca726bULL},
+        {"test24-pad1.bmp",       "--resize 320x240",                      0x9070390a6d7aea02ULL},
+        {"test24-pad1.bmp",       "--resize 0x100:lanczos",                0xa3861927b74ffd2bULL},
+        {"test24-pad1.bmp",       "--rotate 90",                           0xc6caa8ad1afde691ULL},
+        {"test24-pad1.bmp",       "--rotate 270 --flip-v",                 0x852f1c9cbbd2f7cdULL},
+        {"test24-pad1.bmp",       "--flip-h --rotate 180",                 0x0dd4f3d3c9aa7e07ULL},
+        {"test24-pad2.bmp",       "-n",                                    0xe228397f66102850ULL},
+        {"test24-pad2.bmp",       "-r -b",                                 0x3c19836764738391ULL},
+        {"test24-pad2.bmp",       "--gamma 2.2 --contrast 1.3 --mask rg",  0x5cfae4a3922b2866ULL},
+        {"test24-pad2.bmp",       "--threshold 128 -n",                    0xc0364329a06ef30bULL},
+        {"test24-pad2.bmp",       "--crop 10,20,300,200 -s",               0x4ab1345e377dd47aULL},
+        {"test24-pad2.bmp",       "--autolevels",                          0xc568ebe44fc012d6ULL},
+        {"test24-pad2.bmp",       "-g 4",                                  0x90b5d867dcf1e08aULL},
+        {"test24-pad2.bmp",       "-S",                                    0xb88efcf507c00440ULL},
+        {"test24-pad2.bmp",       "--resize 320x240",                      0x0db3c09842ab1809ULL},
+        {"test24-pad2.bmp",       "--resize 0x100:lanczos",                0xc0eca28a3eb5321dULL},
+        {"test24-pad2.bmp",       "--rotate 90",                           0x570159d49e1e7800ULL},
+        {"test24-pad2.bmp",       "--rotate 270 --flip-v",                 0x08d50d91779cdda8ULL},
+        {"test24-pad2.bmp",       "--flip-h --rotate 180",                 0xada18e54d1e9fba8ULL},
+        {"test24-pad3.bmp",       "-n",                                    0x59e1254735517289ULL},
+        {"test24-pad3.bmp",       "-r -b",                                 0xf60dc2ecb9adfab3ULL},
+        {"test24-pad3.bmp",       "--gamma 2.2 --contrast 1.3 --mask rg",  0xaec698358983005dULL},
+        {"test24-pad3.bmp",       "--threshold 128 -n",                    0xe3af678cd7f5be4eULL},
+        {"test24-pad3.bmp",       "--crop 10,20,300,200 -s",               0xa6f96f4ea67b9ed7ULL},
+        {"test24-pad3.bmp",       "--autolevels",                          0x84deb52c4fb108eaULL},
+        {"test24-pad3.bmp",       "-g 4",                                  0x4a0f26a4e7e69b9fULL},
+        {"test24-pad3.bmp",       "-S",                                    0x9c4c1ff0d2d67a7eULL},
+        {"test24-pad3.bmp",       "--resize 320x240",                      0xd8ca5552fa85a512ULL},
+        {"test24-pad3.bmp",       "--resize 0x100:lanczos",                0xe1ce3c6ef6be2aa2ULL},
+        {"test24-pad3.bmp",       "--rotate 90",                           0x77f5395b276d60beULL},
+        {"test24-pad3.bmp",       "--rotate 270 --flip-v",                 0x9c61073a0439d2d2ULL},
+        {"test24-pad3.bmp",       "--flip-h --rotate 180",                 0x00034203cfff7222ULL},
+        {"synthetic-24bit-12mp",  "-n",                                    0x2f3c1e2759886466ULL},
+        {"synthetic-24bit-12mp",  "-r -b",                                 0xb590cc81aa94549fULL},
+        {"synthetic-24bit-12mp",  "--gamma 2.2 --contrast 1.3 --mask rg",  0x7c4102d94de2060eULL},
+        {"synthetic-24bit-12mp",  "--threshold 128 -n",                    0x275d981d6f406bd2ULL},
+        {"synthetic-24bit-12mp",  "--crop 10,20,300,200 -s",               0xc0d83d8388034b4dULL},
+        {"synthetic-24bit-12mp",  "--autolevels",                          0x21688cd6e952e474ULL},
+        {"synthetic-24bit-12mp",  "-g 4",                                  0x2cec5b465e3d4382ULL},
+        {"synthetic-24bit-12mp",  "-S",                                    0xda0772a17b160c5eULL},
+        {"synthetic-24bit-12mp",  "--resize 320x240",                      0xc6bcaa837f1e513bULL},
+        {"synthetic-24bit-12mp",  "--resize 0x100:lanczos",                0x0ba3eaeae01d4d19ULL},
+        {"synthetic-24bit-12mp",  "--rotate 90",                           0x54550796e57e584eULL},
+        {"synthetic-24bit-12mp",  "--rotate 270 --flip-v",                 0xa233165d7249e34cULL},
+        {"synthetic-24bit-12mp",  "--flip-h --rotate 180",                 0x1887ff55b9f6cff6ULL},
+        {"synthetic-32bit-8mp",   "-n",                                    0xb8cd507aa1989e8cULL},
+        {"synthetic-32bit-8mp",   "-r -b",                                 0x983256d77b0b4e7eULL},
+        {"synthetic-32bit-8mp",   "--gamma 2.2 --contrast 1.3 --mask rg",  0xa7c7fbbab2712dafULL},
+        {"synthetic-32bit-8mp",   "--threshold 128 -n",                    0xb7b0a4bc89a3edb8ULL},
+        {"synthetic-32bit-8mp",   "--crop 10,20,300,200 -s",               0x5f088b70fea572b3ULL},
+        {"synthetic-32bit-8mp",   "--autolevels",                          0x9dc4b4bfbc9cc548ULL},
+        {"synthetic-32bit-8mp",   "-g 4",                                  0xe88231d2fd2a201aULL},
+        {"synthetic-32bit-8mp",   "-S",                                    0xde01a8007725c0ddULL},
+        {"synthetic-32bit-8mp",   "--resize 320x240",                      0xf5f83020ef95c059ULL},
+        {"synthetic-32bit-8mp",   "--resize 0x100:lanczos",                0x393991b72d6c5c0fULL},
+        {"synthetic-32bit-8mp",   "--rotate 90",                           0x0bb8a115eb2be638ULL},
+        {"synthetic-32bit-8mp",   "--rotate 270 --flip-v",                 0xd21c32572f0c0c94ULL},
+        {"synthetic-32bit-8mp",   "--flip-h --rotate 180",                 0x6d4b0ddb7edce44cULL},
+        {"synthetic-8bit-3mp",    "-n",                                    0x7db597bfc3c4b704ULL},
+        {"synthetic-8bit-3mp",    "-r -b",                                 0x07aa503a90953753ULL},
+        {"synthetic-8bit-3mp",    "--gamma 2.2 --contrast 1.3 --mask rg",  0xfcfc62863502c9daULL},
+        {"synthetic-8bit-3mp",    "--threshold 128 -n",                    0x4ab980686b945f40ULL},
+        {"synthetic-8bit-3mp",    "--crop 10,20,300,200 -s",               0x962a143f45b919cbULL},
+        {"synthetic-8bit-3mp",    "--autolevels",                          0x66c44f59af4ac7b4ULL},
+        {"synthetic-8bit-3mp",    "-g 4",                                  REFUS_BANC},
+        {"synthetic-8bit-3mp",    "-S",                                    REFUS_BANC},
+        {"synthetic-8bit-3mp",    "--resize 320x240",                      REFUS_BANC},
+        {"synthetic-8bit-3mp",    "--resize 0x100:lanczos",                REFUS_BANC},
+        {"synthetic-8bit-3mp",    "--rotate 90",                           0xa84584c60e35184aULL},
+        {"synthetic-8bit-3mp",    "--rotate 270 --flip-v",                 0x84c9bfcc94f94900ULL},
+        {"synthetic-8bit-3mp",    "--flip-h --rotate 180",                 0xf727fe77caed3a50ULL},
+        {"synthetic-16bit-3mp",   "-n",                                    0xc92c4d8352fa2a2bULL},
+        {"synthetic-16bit-3mp",   "-r -b",                                 0xc6940c08a0776feeULL},
+        {"synthetic-16bit-3mp",   "--gamma 2.2 --contrast 1.3 --mask rg",  0x329ac4d992c1a28eULL},
+        {"synthetic-16bit-3mp",   "--threshold 128 -n",                    0x0f659564f117d164ULL},
+        {"synthetic-16bit-3mp",   "--crop 10,20,300,200 -s",               0x8ee2d7e264f60b35ULL},
+        {"synthetic-16bit-3mp",   "--autolevels",                          0xc8c1b973168d77c3ULL},
+        {"synthetic-16bit-3mp",   "-g 4",                                  0xbc9f997dd76fd977ULL},
+        {"synthetic-16bit-3mp",   "-S",                                    0xb892b4bd41fd1bc8ULL},
+        {"synthetic-16bit-3mp",   "--resize 320x240",                      0x4dae9d0fdcd63345ULL},
+        {"synthetic-16bit-3mp",   "--resize 0x100:lanczos",                0xc0084807f9d30344ULL},
+        {"synthetic-16bit-3mp",   "--rotate 90",                           0xb46b1768fbabf24bULL},
+        {"synthetic-16bit-3mp",   "--rotate 270 --flip-v",                 0xa48ff71e812d3407ULL},
+        {"synthetic-16bit-3mp",   "--flip-h --rotate 180",                 0x6ea7951197b37b47ULL},
+        {NULL, NULL, 0},
+};
+
+/**
+ * @brief Returns the current time of the monotonic clock in seconds.
+ */
+static double maintenant(void)
+{
+    struct timespec temps;
+    clock_gettime(CLOCK_MONOTONIC, &temps);
+    return temps.tv_sec + temps.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Adds bytes to a 64-bit FNV-1a hash.
+ */
+static uint64_t hacher(uint64_t empreinte, const void *donnees, size_t taille)
+{
+    const unsigned char *octets = donnees;
+    for (size_t i = 0; i < taille; i++)
+    {
+        empreinte ^= octets[i];
+        empreinte *= 0x100000001B3ULL;
+    }
+    return empreinte;
+}
+
+/**
+ * @brief Hashes the dimensions, the depth and the pixels of a BMP file, row padding excluded.
+ *
+ * @param chemin Path of the BMP file.
+ * @param empreinte Receives the 64-bit FNV-1a hash.
+ * @return 0 on success, -1 if the file cannot be read.
+ */
+int empreinte_bmp(const char *chemin, uint64_t *empreinte)
+{
+    int fd = open(chemin, O_RDONLY);
+    if (fd == -1)
+        return -1;
+
+    entete_bmp entete;
+    unsigned char *pixels = NULL;
+    int resultat = -1;
+
+    if (lire_entete(fd, &entete) == 0 && verifier_entete(&entete) && (pixels = allouer_pixels(&entete)) != NULL
+        && lire_pixels(fd, &entete, pixels) == 0)
+    {
+        size_t octets = (size_t) entete.bitmap.largeur * octets_par_pixel(&entete);
+        uint64_t somme = 0xCBF29CE484222325ULL;
+
+        somme = hacher(somme, &entete.bitmap.largeur, sizeof(entete.bitmap.largeur));
+        somme = hacher(somme, &entete.bitmap.hauteur, sizeof(entete.bitmap.hauteur));
+        somme = hacher(somme, &entete.bitmap.profondeur, sizeof(entete.bitmap.profondeur));
+        for (uint32_t line = 0; line < entete.bitmap.hauteur; line++)
+            somme = hacher(somme, pixels + line * taille_ligne(&entete), octets);
+
+        // the palette is part of the image, it is modified by the point filters
+        if (format_image(&entete) == FORMAT_PALETTE_8)
+        {
+            uint32_t couleurs;
+            unsigned char *palette = palette_image(&entete, &couleurs);
+            somme = hacher(somme, palette, (size_t) couleurs * 4);
+        }
+
+        *empreinte = somme;
+        resultat = 0;
+    }
+
+    free(pixels);
+    close(fd);
+    return resultat;
+}
+
+/**
+ * @brief Writes a synthetic image with deterministic pseudo-random content.
+ *
+ * The channels are gradients of different slopes with a few levels of noise, so that every filter has
+ * edges and flat areas to work on and the histograms are not degenerate.
+ *
+ * @param chemin Path of the image to write.
+ * @param synthetique Dimensions and depth of the image.
+ * @return 0 on success, -1 on error.
+ */
+int ecrire_synthetique(const char *chemin, const synthetique_banc *synthetique)
+{
+    entete_bmp entete = {0};
+    entete.fichier.signature = 0x4D42;
+    entete.bitmap.taille_entete = TAILLE_ENTETES - TAILLE_ENTETE_FICHIER;
+    entete.bitmap.largeur = synthetique->largeur;
+    entete.bitmap.hauteur = synthetique->hauteur;
+    entete.bitmap.nombre_plans = 1;
+    entete.bitmap.profondeur = synthetique->profondeur;
+    entete.bitmap.compression = COMPRESSION_AUCUNE;
+    entete.bitmap.resolution_horizontale = entete.bitmap.resolution_verticale = 2835;
+
+    if (synthetique->profondeur == 8)
+    {
+        // a full palette whose channels vary at different rates, so that an index maps to a distinct color
+        entete.bitmap.taille_palette = 256;
+        entete.taille_extension = 256 * 4;
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            entete.extension[4 * i] = (unsigned char) i;
+            entete.extension[4 * i + 1] = (unsigned char) (255 - i);
+            entete.extension[4 * i + 2] = (unsigned char) (i * 7);
+        }
+    } else if (synthetique->profondeur == 16)
+    {
+        // the red, green and blue masks of 565 pixels
+        uint32_t masques[] = {0xF800, 0x07E0, 0x001F};
+        entete.bitmap.compression = COMPRESSION_CHAMPS_BITS;
+        entete.taille_extension = sizeof(masques);
+        memcpy(entete.extension, masques, sizeof(masques));
+    }
+    entete.fichier.offset_donnees = TAILLE_ENTETES + entete.taille_extension;
+    ajuster_tailles(&entete);
+
+    unsigned char *pixels = allouer_pixels(&entete);
+    if (!pixels)
+        return -1;
+
+    uint32_t octets = octets_par_pixel(&entete);
+    uint32_t alea = 2463534242u;
+    for (uint32_t line = 0; line < entete.bitmap.hauteur; line++)
+    {
+        unsigned char *x = pixels + line * taille_ligne(&entete);
+        for (uint32_t col = 0; col < entete.bitmap.largeur; col++, x += octets)
+        {
+            // xorshift32
+            alea ^= alea << 13;
+            alea ^= alea >> 17;
+            alea ^= alea << 5;
+            for (uint32_t canal = 0; canal < octets; canal++)
+            {
+                uint32_t degrade = (col * (canal + 1) * 255 / entete.bitmap.largeur + line * 255 / entete.bitmap.hauteur) / 2;
+                x[canal] = (unsigned char) (degrade + (alea >> (8 * canal) & 15));
+            }
+        }
+    }
+
+    int fd = open(chemin, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int resultat = fd != -1 && ecrire_entete(fd, &entete) == 0 && ecrire_pixels(fd, &entete, pixels) == 0 ? 0 : -1;
+    if (fd != -1)
+        close(fd);
+    free(pixels);
+    return resultat;
+}
+
+/**
+ * @brief Looks up the reference hash of a case.
+ *
+ * @return Pointer to the reference, or NULL if the case has none.
+ */
+static const reference_banc *chercher_reference(const char *image, const char *filtres)
+{
+    for (size_t i = 0; references[i].image != NULL; i++)
+    {
+        if (strcmp(references[i].image, image) == 0 && strcmp(references[i].filtres, filtres) == 0)
+            return &references[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Splits the options of a case on spaces.
+ *
+ * @param filtres The options of the case, left intact.
+ * @param copie Receives the split copy the options point into.
+ * @param taille Size of copie.
+ * @param options Receives at most OPTIONS_BANC_MAX options.
+ * @return The number of options.
+ */
+static int decouper_options(const char *filtres, char *copie, size_t taille, char *options[])
+{
+    int nb_options = 0;
+
+    snprintf(copie, taille, "%s", filtres);
+    for (char *option = strtok(copie, " "); option && nb_options < OPTIONS_BANC_MAX; option = strtok(NULL, " "))
+        options[nb_options++] = option;
+    return nb_options;
+}
+
+/**
+ * @brief Runs the cases of one image and prints a line per case and mode.
+ *
+ * @param nom Name of the image in the report.
+ * @param entree Path of the image.
+ * @param sortie Path of the scratch output file.
+ * @param tampon Pixel buffer reused by the in-memory runs.
+ * @return The number of cases whose output is missing or differs from its reference.
+ */
+static int executer_image(const char *nom, const char *entree, const char *sortie, tampon_pixels *tampon)
+{
+    int echecs = 0;
+
+    for (size_t i = 0; i < sizeof(cas) / sizeof(cas[0]); i++)
+    {
+        char filtres[256];
+        char *options[OPTIONS_BANC_MAX];
+        int nb_options = decouper_options(cas[i].filtres, filtres, sizeof(filtres), options);
+
+        for (int flux = 0; flux <= cas[i].flux; flux++)
+        {
+            entete_bmp entete;
+            double meilleure = 0;
+            int resultat = 0;
+
+            for (int repetition = 0; resultat == 0 && repetition < REPETITIONS_BANC; repetition++)
+            {
+                double debut = maintenant();
+                resultat = flux ? modif_bmp_flux(entree, sortie, options, nb_options)
+                                : modifier_bmp(entree, sortie, options, nb_options, tampon, &entete);
+                double duree = maintenant() - debut;
+                if (repetition == 0 || duree < meilleure)
+                    meilleure = duree;
+            }
+
+            uint64_t empreinte = 0;
+            const reference_banc *reference = chercher_reference(nom, cas[i].filtres);
+            const char *verdict = "ok";
+            if (resultat == -1 && reference && reference->empreinte == REFUS_BANC)
+                verdict = "refused";
+            else if (resultat == -1 || empreinte_bmp(sortie, &empreinte) == -1)
+                verdict = "FAILED";
+            else if (!reference)
+                verdict = "no reference";
+            else if (reference->empreinte != empreinte)
+                verdict = "MISMATCH";
+            if (strcmp(verdict, "ok") != 0 && strcmp(verdict, "refused") != 0)
+                echecs++;
+
+            // the throughput is counted in input pixels, whatever the size of the output
+            int fd = open(entree, O_RDONLY);
+            uint64_t pixels = 0;
+            if (fd != -1 && lire_entete(fd, &entete) == 0)
+                pixels = (uint64_t) entete.bitmap.largeur * entete.bitmap.hauteur;
+            if (fd != -1)
+                close(fd);
+
+            printf("%-22s %-38s %-6s %9.2f ms %9.2f MPix/s  %016llx  %s\n", nom, cas[i].filtres,
+                   flux ? "stream" : "memory", meilleure * 1e3, meilleure > 0 ? pixels / 1e6 / meilleure : 0,
+                   (unsigned long long) empreinte, verdict);
+        }
+    }
+
+    return echecs;
+}
+
+/**
+ * @brief Runs every case in batch mode over the test images and prints a line per case and mode.
+ *
+ * The summary of the batch mode is silenced, its outputs are checked against the references of the
+ * single-image runs.
+ *
+ * @param dossier Directory of the test images.
+ * @return The number of test images whose output is missing or differs from its reference.
+ */
+static int executer_lot(const char *dossier)
+{
+    size_t const nb_images = sizeof(images) / sizeof(images[0]);
+    int echecs = 0;
+
+    for (size_t i = 0; i < sizeof(cas) / sizeof(cas[0]); i++)
+    {
+        char filtres[256];
+        char *options[OPTIONS_BANC_MAX];
+        int nb_options = decouper_options(cas[i].filtres, filtres, sizeof(filtres), options);
+
+        for (int flux = 0; flux <= cas[i].flux; flux++)
+        {
+            char destination[] = "/tmp/r305-banc-XXXXXX";
+            if (!mkdtemp(destination))
+            {
+                printf("Error: Cannot create the scratch directory of the benchmark\n");
+                echecs += nb_images;
+                continue;
+            }
+
+            char *arguments[OPTIONS_BANC_MAX + 6];
+            int nb_arguments = 0;
+            arguments[nb_arguments++] = OPTION_LOT;
+            arguments[nb_arguments++] = (char *) dossier;
+            arguments[nb_arguments++] = destination;
+            arguments[nb_arguments++] = OPTION_TRAVAILLEURS;
+            arguments[nb_arguments++] = TRAVAILLEURS_BANC;
+            if (flux)
+                arguments[nb_arguments++] = OPTION_FLUX;
+            for (int j = 0; j < nb_options; j++)
+                arguments[nb_arguments++] = options[j];
+
+            fflush(stdout);
+            int sauvegarde = dup(STDOUT_FILENO);
+            int nul = open("/dev/null", O_WRONLY);
+            if (nul != -1)
+            {
+                dup2(nul, STDOUT_FILENO);
+                close(nul);
+            }
+            double debut = maintenant();
+            int resultat = run_modif_bmp_lot(nb_arguments, arguments);
+            double duree = maintenant() - debut;
+            fflush(stdout);
+            if (sauvegarde != -1)
+            {
+                dup2(sauvegarde, STDOUT_FILENO);
+                close(sauvegarde);
+            }
+
+            size_t identiques = 0;
+            for (size_t j = 0; resultat == 0 && j < nb_images; j++)
+            {
+                char chemin[sizeof(destination) + strlen(images[j]) + 1];
+                sprintf(chemin, "%s/%s", destination, images[j]);
+                const reference_banc *reference = chercher_reference(images[j], cas[i].filtres);
+                uint64_t empreinte;
+                if (reference && empreinte_bmp(chemin, &empreinte) == 0 && empreinte == reference->empreinte)
+                    identiques++;
+            }
+            echecs += nb_images - identiques;
+
+            printf("%-22s %-38s %-6s %9.2f ms %9zu/%zu identical  %s\n", "batch", cas[i].filtres,
+                   flux ? "stream" : "memory", duree * 1e3, identiques, nb_images,
+                   resultat == -1 ? "FAILED" : identiques == nb_images ? "ok" : "MISMATCH");
+
+            // every image of the directory was written, not only the test images
+            char **chemins;
+            int nb_chemins;
+            if (lister_images(destination, &chemins, &nb_chemins) == 0)
+            {
+                for (int j = 0; j < nb_chemins; j++)
+                {
+                    unlink(chemins[j]);
+                    free(chemins[j]);
+                }
+                free(chemins);
+            }
+            rmdir(destination);
+        }
+    }
+
+    return echecs;
+}
+
+/**
+ * @brief Runs the benchmark.
+ *
+ * @param argc The number of arguments, OPTION_BANC included.
+ * @param argv The arguments, starting with OPTION_BANC, optionally followed by the directory of the test images.
+ * @return 0 if every output matches its reference, -1 otherwise.
+ */
+int run_modif_bmp_banc(int argc, char *argv[])
+{
+    const char *dossier = argc > 1 ? argv[1] : DOSSIER_BANC;
+    char sortie[] = "/tmp/r305-banc-XXXXXX";
+    char synthetique[] = "/tmp/r305-banc-XXXXXX";
+    int echecs = 0;
+
+    int fd_sortie = mkstemp(sortie);
+    int fd_synthetique = mkstemp(synthetique);
+    if (fd_sortie == -1 || fd_synthetique == -1)
+    {
+        printf("Error: Cannot create the scratch files of the benchmark\n");
+        if (fd_sortie != -1)
+            unlink(sortie);
+        if (fd_synthetique != -1)
+            unlink(synthetique);
+        return -1;
+    }
+    close(fd_sortie);
+    close(fd_synthetique);
+
+    tampon_pixels tampon = {NULL, 0};
+    for (size_t i = 0; i < sizeof(images) / sizeof(images[0]); i++)
+    {
+        char entree[strlen(dossier) + strlen(images[i]) + 2];
+        sprintf(entree, "%s/%s", dossier, images[i]);
+        echecs += executer_image(images[i], entree, sortie, &tampon);
+    }
+
+    for (size_t i = 0; i < sizeof(synthetiques) / sizeof(synthetiques[0]); i++)
+    {
+        if (ecrire_synthetique(synthetique, &synthetiques[i]) == -1)
+        {
+            printf("Error: Cannot write the synthetic image %s\n", synthetiques[i].nom);
+            echecs++;
+            continue;
+        }
+        echecs += executer_image(synthetiques[i].nom, synthetique, sortie, &tampon);
+    }
+
+    liberer_pixels(&tampon);
+    unlink(sortie);
+    unlink(synthetique);
+
+    echecs += executer_lot(dossier);
+
+    printf("%d case(s) failed\n", echecs);
+    return echecs ? -1 : 0;
+}
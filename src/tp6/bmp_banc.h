@@ -0,0 +1,89 @@
+/**
+ * @file bmp_banc.h
+ * @brief Benchmark and golden-image check of the filters of the BMP modification tool.
+ *
+ * Every filter is run on the images of ressources/tp6, which cover the four row paddings, and on synthetic
+ * images of several megapixels, in memory and, when the filter allows it, in streaming mode. The pixels of
+ * each output are hashed and compared with the hash recorded when the output was last known to be right,
+ * and the throughput of each run is reported. Every case is then run once more in batch mode over the
+ * test images, whose outputs must match the same hashes.
+ */
+
+#ifndef R305_BMP_BANC_H
+#define R305_BMP_BANC_H
+
+#include <stdint.h>
+#include "modif_bmp.h"
+
+/// First argument of --modif_bmp selecting the benchmark, optionally followed by the directory of the test images
+#define OPTION_BANC "--bench"
+
+/// Directory of the test images, relative to the root of the repository
+#define DOSSIER_BANC "ressources/tp6"
+
+/// Number of runs of each case, the fastest one is reported
+#define REPETITIONS_BANC 3
+
+/// Largest number of options of a case
+#define OPTIONS_BANC_MAX 16
+
+/// Hash recorded for a case whose filters must refuse the format of the image
+#define REFUS_BANC 0
+
+/// Number of worker threads of the batch runs
+#define TRAVAILLEURS_BANC "4"
+
+/// A list of filters run by the benchmark
+typedef struct
+{
+    const char *filtres;  ///< the options, separated by spaces
+    int flux;             ///< 1 if the options are also run in streaming mode
+} cas_banc;
+
+/// The hash of a known good output
+typedef struct
+{
+    const char *image;    ///< name of the input image
+    const char *filtres;  ///< the options, as in cas_banc
+    uint64_t empreinte;   ///< hash of the output, see empreinte_bmp, or REFUS_BANC
+} reference_banc;
+
+/// A synthetic input image, generated at each run
+typedef struct
+{
+    const char *nom;      ///< name of the image in the report and in the references
+    uint32_t largeur;
+    uint32_t hauteur;
+    uint16_t profondeur;  ///< 8 (paletted), 16 (565 bit fields), 24 or 32 bits
+} synthetique_banc;
+
+/**
+ * @brief Hashes the dimensions, the depth and the pixels of a BMP file, row padding excluded.
+ *
+ * The padding is left out since the in-memory and streaming modes may write different bytes there.
+ *
+ * @param chemin Path of the BMP file.
+ * @param empreinte Receives the 64-bit FNV-1a hash.
+ * @return 0 on success, -1 if the file cannot be read.
+ */
+int empreinte_bmp(const char *chemin, uint64_t *empreinte);
+
+/**
+ * @brief Writes a synthetic image with deterministic pseudo-random content.
+ *
+ * @param chemin Path of the image to write.
+ * @param synthetique Dimensions and depth of the image.
+ * @return 0 on success, -1 on error.
+ */
+int ecrire_synthetique(const char *chemin, const synthetique_banc *synthetique);
+
+/**
+ * @brief Runs the benchmark.
+ *
+ * @param argc The number of arguments, OPTION_BANC included.
+ * @param argv The arguments, starting with OPTION_BANC, optionally followed by the directory of the test images.
+ * @return 0 if every output matches its reference, -1 otherwise.
+ */
+int run_modif_bmp_banc(int argc, char *argv[]);
+
+#endif //R305_BMP_BANC_H
@@ -0,0 +1,185 @@
+/**
+ * @file bmp_convolution.c
+ * @brief Blur and sharpen filters of the BMP modification tool.
+ *
+ * The image is unpacked to 4-byte pixels, each pixel being widened to four vector lanes while it is
+ * accumulated, so that a single vector addition updates the running sums of all its channels.
+ */
+
+#include <stdlib.h>
+#include "bmp_convolution.h"
+#include "bmp_simd.h"
+
+/**
+ * @brief Transposes an image of 4-byte pixels tile by tile.
+ *
+ * Within a tile, the rows read and the rows written both stay in the cache, instead of every write
+ * of a column landing on a different cache line.
+ *
+ * @param source The image, `hauteur` rows of `largeur` pixels.
+ * @param destination Receives the transposed image, `largeur` rows of `hauteur` pixels.
+ * @param largeur The width of the source.
+ * @param hauteur The height of the source.
+ */
+void transposer(const uint32_t *source, uint32_t *destination, uint32_t largeur, uint32_t hauteur)
+{
+    for (uint32_t y0 = 0; y0 < hauteur; y0 += TAILLE_TUILE)
+    {
+        uint32_t y1 = hauteur - y0 < TAILLE_TUILE ? hauteur : y0 + TAILLE_TUILE;
+        for (uint32_t x0 = 0; x0 < largeur; x0 += TAILLE_TUILE)
+        {
+            uint32_t x1 = largeur - x0 < TAILLE_TUILE ? largeur : x0 + TAILLE_TUILE;
+            for (uint32_t y = y0; y < y1; y++)
+            {
+                for (uint32_t x = x0; x < x1; x++)
+                {
+                    destination[(size_t) x * hauteur + y] = source[(size_t) y * largeur + x];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Applies a horizontal box blur to every row of an image of 4-byte pixels.
+ *
+ * The sum of the 2 * rayon + 1 pixels of the box is updated by adding the pixel entering the box and
+ * removing the one leaving it, whatever the radius. Pixels outside the image repeat the edge pixels.
+ * The division by the size of the box is a multiplication by its 16-bit fixed-point inverse, rounded
+ * down so that the result never exceeds 255.
+ *
+ * @param image The image, blurred in place.
+ * @param largeur The width of the image.
+ * @param hauteur The height of the image.
+ * @param rayon The radius of the box.
+ * @param ligne A buffer of `largeur` vectors holding the widened pixels of the current row.
+ */
+static void flou_lignes(uint32_t *image, uint32_t largeur, uint32_t hauteur, uint32_t rayon, v4si *ligne)
+{
+    int32_t const inverse = (1 << 16) / (2 * rayon + 1);
+    uint32_t const dernier = largeur - 1;
+
+    for (uint32_t line = 0; line < hauteur; line++)
+    {
+        uint32_t *pixels = image + (size_t) line * largeur;
+
+        for (uint32_t col = 0; col < largeur; col++)
+            ligne[col] = charger_pixel(pixels + col);
+
+        v4si somme = ligne[0] * (int32_t) (rayon + 1);
+        for (uint32_t j = 1; j <= rayon; j++)
+            somme += ligne[j < dernier ? j : dernier];
+
+        for (uint32_t col = 0; col < largeur; col++)
+        {
+            ranger_pixel(pixels + col, (somme * inverse + (1 << 15)) >> 16);
+
+            uint32_t entrant = col + rayon + 1;
+            somme += ligne[entrant < dernier ? entrant : dernier] - ligne[col > rayon ? col - rayon : 0];
+        }
+    }
+}
+
+/**
+ * @brief Blurs an image of 4-byte pixels with `passes` box blurs in each direction.
+ *
+ * Box blurs commute, so all the horizontal passes run first, then the image is transposed once for
+ * all the vertical passes and transposed back.
+ *
+ * @param image The image, `hauteur` rows of `largeur` pixels, blurred in place.
+ * @param transposee A buffer of the same size, used for the vertical passes.
+ * @param largeur The width of the image.
+ * @param hauteur The height of the image.
+ * @param rayon The radius of the boxes.
+ * @param passes The number of box blurs in each direction.
+ * @return 0 on success, -1 if memory allocation failed.
+ */
+int flou_boites(uint32_t *image, uint32_t *transposee, uint32_t largeur, uint32_t hauteur, uint32_t rayon,
+                int passes)
+{
+    if (largeur == 0 || hauteur == 0)
+        return 0;
+
+    v4si *ligne = malloc((largeur > hauteur ? largeur : hauteur) * sizeof(v4si));
+    if (!ligne)
+        return -1;
+
+    for (int passe = 0; passe < passes; passe++)
+        flou_lignes(image, largeur, hauteur, rayon, ligne);
+
+    transposer(image, transposee, largeur, hauteur);
+    for (int passe = 0; passe < passes; passe++)
+        flou_lignes(transposee, hauteur, largeur, rayon, ligne);
+    transposer(transposee, image, hauteur, largeur);
+
+    free(ligne);
+    return 0;
+}
+
+/**
+ * @brief Blurs a view of an image, approximating a Gaussian blur of standard deviation close to the radius.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ * @param rayon The radius of the blur, between 1 and RAYON_FLOU_MAX.
+ * @return 0 on success, -1 on error (paletted image, invalid radius or allocation failure).
+ */
+int flou(entete_bmp *entete, unsigned char *pixels, size_t pas, uint32_t rayon)
+{
+    uint32_t largeur = entete->bitmap.largeur, hauteur = entete->bitmap.hauteur;
+    size_t taille = (size_t) largeur * hauteur;
+
+    if (rayon < 1 || rayon > RAYON_FLOU_MAX)
+        return -1;
+
+    uint32_t *image = malloc(taille * sizeof(uint32_t));
+    uint32_t *transposee = malloc(taille * sizeof(uint32_t));
+    int resultat = -1;
+
+    if (image && transposee && deballer_pixels(entete, pixels, pas, image) == 0
+        && flou_boites(image, transposee, largeur, hauteur, rayon, PASSES_FLOU) == 0)
+    {
+        emballer_pixels(entete, pixels, pas, image);
+        resultat = 0;
+    }
+
+    free(image);
+    free(transposee);
+    return resultat;
+}
+
+/**
+ * @brief Sharpens a view of an image with an unsharp mask: each pixel moves away from the mean of its 3x3 block.
+ *
+ * The result is 2 * pixel - mean, clamped to [0, 255].
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ * @return 0 on success, -1 on error (paletted image or allocation failure).
+ */
+int nettete(entete_bmp *entete, unsigned char *pixels, size_t pas)
+{
+    uint32_t largeur = entete->bitmap.largeur, hauteur = entete->bitmap.hauteur;
+    size_t taille = (size_t) largeur * hauteur;
+
+    uint32_t *moyenne = malloc(taille * sizeof(uint32_t));
+    uint32_t *image = malloc(taille * sizeof(uint32_t));
+    int resultat = -1;
+
+    // the transposition buffer of the blur is reused for the original pixels once the blur is done
+    if (moyenne && image && deballer_pixels(entete, pixels, pas, moyenne) == 0
+        && flou_boites(moyenne, image, largeur, hauteur, 1, 1) == 0)
+    {
+        deballer_pixels(entete, pixels, pas, image);
+        for (size_t i = 0; i < taille; i++)
+            ranger_pixel(image + i, saturer(2 * charger_pixel(image + i) - charger_pixel(moyenne + i)));
+        emballer_pixels(entete, pixels, pas, image);
+        resultat = 0;
+    }
+
+    free(moyenne);
+    free(image);
+    return resultat;
+}
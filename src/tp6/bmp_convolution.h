@@ -0,0 +1,77 @@
+/**
+ * @file bmp_convolution.h
+ * @brief Blur and sharpen filters of the BMP modification tool.
+ *
+ * Both filters are built from box blurs computed as separable passes with running sums, so their cost per
+ * pixel does not depend on the radius. The vertical pass runs on a transposed copy of the image, produced
+ * tile by tile, so that it walks memory row by row like the horizontal pass.
+ */
+
+#ifndef R305_BMP_CONVOLUTION_H
+#define R305_BMP_CONVOLUTION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "modif_bmp.h"
+
+/// Option of --modif_bmp blurring the image, followed by the radius
+#define OPTION_FLOU "-g"
+
+/// Option of --modif_bmp sharpening the image
+#define OPTION_NETTETE "-S"
+
+/// Largest radius accepted by the blur
+#define RAYON_FLOU_MAX 100
+
+/// Number of box blurs chained to approximate a Gaussian blur
+#define PASSES_FLOU 3
+
+/// Side in pixels of the square tiles of the transposition, 32 * 32 * 4 bytes fit in the L1 cache
+#define TAILLE_TUILE 32
+
+/**
+ * @brief Transposes an image of 4-byte pixels tile by tile.
+ *
+ * @param source The image, `hauteur` rows of `largeur` pixels.
+ * @param destination Receives the transposed image, `largeur` rows of `hauteur` pixels.
+ * @param largeur The width of the source.
+ * @param hauteur The height of the source.
+ */
+void transposer(const uint32_t *source, uint32_t *destination, uint32_t largeur, uint32_t hauteur);
+
+/**
+ * @brief Blurs an image of 4-byte pixels with `passes` box blurs in each direction.
+ *
+ * @param image The image, `hauteur` rows of `largeur` pixels, blurred in place.
+ * @param transposee A buffer of the same size, used for the vertical passes.
+ * @param largeur The width of the image.
+ * @param hauteur The height of the image.
+ * @param rayon The radius of the boxes.
+ * @param passes The number of box blurs in each direction.
+ * @return 0 on success, -1 if memory allocation failed.
+ */
+int flou_boites(uint32_t *image, uint32_t *transposee, uint32_t largeur, uint32_t hauteur, uint32_t rayon,
+                int passes);
+
+/**
+ * @brief Blurs a view of an image, approximating a Gaussian blur of standard deviation close to the radius.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ * @param rayon The radius of the blur, between 1 and RAYON_FLOU_MAX.
+ * @return 0 on success, -1 on error (paletted image, invalid radius or allocation failure).
+ */
+int flou(entete_bmp *entete, unsigned char *pixels, size_t pas, uint32_t rayon);
+
+/**
+ * @brief Sharpens a view of an image with an unsharp mask: each pixel moves away from the mean of its 3x3 block.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ * @return 0 on success, -1 on error (paletted image or allocation failure).
+ */
+int nettete(entete_bmp *entete, unsigned char *pixels, size_t pas);
+
+#endif //R305_BMP_CONVOLUTION_H
@@ -0,0 +1,312 @@
+/**
+ * @file bmp_flux.c
+ * @brief Streaming mode of the BMP modification tool.
+ *
+ * The image is read in bands of rows by a dedicated thread while the calling thread filters
+ * and writes the previous band, so that memory usage is bounded by two bands whatever the
+ * size of the image.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <stdio.h>
+#include "bmp_flux.h"
+#include "bmp_tables.h"
+
+/**
+ * @brief Computes the part of the image kept by the geometric options (-s, -i and --crop) of a filter list.
+ *
+ * Rows are stored bottom-up: the upper half is the second half in file order and the top edge of a
+ * rectangle is counted from the last row of the file, exactly as moitie() and rogner() do.
+ *
+ * @param entete Header of the input image.
+ * @param options The filter options, in command-line order.
+ * @param nb_options The number of options.
+ * @param colonne Receives the index of the first kept column.
+ * @param premiere Receives the index of the first kept row, in file order.
+ * @param largeur Receives the number of kept columns.
+ * @param nombre Receives the number of kept rows.
+ * @return 0 on success, -1 if a --crop rectangle is malformed or outside the image.
+ */
+int fenetre_conservee(const entete_bmp *entete, char **options, int nb_options, uint32_t *colonne,
+                      uint32_t *premiere, uint32_t *largeur, uint32_t *nombre)
+{
+    *colonne = 0;
+    *premiere = 0;
+    *largeur = entete->bitmap.largeur;
+    *nombre = entete->bitmap.hauteur;
+
+    for (int i = 0; i < nb_options; i++)
+    {
+        if (strcmp(options[i], "-s") == 0)
+        {
+            *premiere += *nombre / 2;
+            *nombre /= 2;
+        } else if (strcmp(options[i], "-i") == 0)
+        {
+            *nombre /= 2;
+        } else if (strcmp(options[i], OPTION_ROGNER) == 0)
+        {
+            uint32_t x, y, l, h;
+            if (i + 1 >= nb_options || lire_rectangle(options[++i], &x, &y, &l, &h) == -1
+                || l == 0 || h == 0 || x > *largeur || l > *largeur - x || y > *nombre || h > *nombre - y)
+            {
+                return -1;
+            }
+            *colonne += x;
+            *premiere += *nombre - y - h;
+            *largeur = l;
+            *nombre = h;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Body of the reader thread.
+ *
+ * Fills the two buffers alternately, waiting for the writer to release a buffer before refilling it.
+ * A band of 0 rows is published at the end of the image or on error.
+ *
+ * @param argument Pointer to the lecteur_flux shared with the writer.
+ * @return NULL
+ */
+static void *lire_bandes(void *argument)
+{
+    lecteur_flux *lecteur = argument;
+
+    for (int tampon = 0;; tampon = 1 - tampon)
+    {
+        pthread_mutex_lock(&lecteur->verrou);
+        while (lecteur->plein[tampon] && !lecteur->arret)
+            pthread_cond_wait(&lecteur->condition, &lecteur->verrou);
+        int arret = lecteur->arret;
+        pthread_mutex_unlock(&lecteur->verrou);
+
+        if (arret)
+            return NULL;
+
+        uint32_t lignes = lecteur->lignes_restantes < lecteur->lignes_par_bande
+                          ? lecteur->lignes_restantes : lecteur->lignes_par_bande;
+        int erreur = 0;
+
+        // the read happens outside the lock so that the writer can work on the other buffer meanwhile
+        if (lignes > 0 && lire_exactement(lecteur->fd, lecteur->tampons[tampon], lignes * lecteur->taille_ligne) == -1)
+        {
+            erreur = 1;
+            lignes = 0;
+        }
+        lecteur->lignes_restantes -= lignes;
+
+        pthread_mutex_lock(&lecteur->verrou);
+        lecteur->lignes[tampon] = lignes;
+        lecteur->erreur = erreur;
+        lecteur->plein[tampon] = 1;
+        pthread_cond_broadcast(&lecteur->condition);
+        pthread_mutex_unlock(&lecteur->verrou);
+
+        if (lignes == 0)
+            return NULL;
+    }
+}
+
+/**
+ * @brief Filters and writes the bands published by the reader thread.
+ *
+ * @param lecteur The state shared with the reader thread.
+ * @param entete Header of the input image, its height is changed to the height of each band.
+ * @param entete_sortie Header of the output image, its height is changed to the height of each band.
+ * @param colonne Index of the first column written.
+ * @param fd_sortie File descriptor of the output image, positioned on the pixel data.
+ * @param chaine The point operations of the options, compiled once for all the bands.
+ * @return 0 on success, -1 on error.
+ */
+static int ecrire_bandes(lecteur_flux *lecteur, entete_bmp *entete, entete_bmp *entete_sortie, uint32_t colonne,
+                         int fd_sortie, const chaine_ponctuelle *chaine)
+{
+    for (int tampon = 0;; tampon = 1 - tampon)
+    {
+        pthread_mutex_lock(&lecteur->verrou);
+        while (!lecteur->plein[tampon])
+            pthread_cond_wait(&lecteur->condition, &lecteur->verrou);
+        uint32_t lignes = lecteur->lignes[tampon];
+        int erreur = lecteur->erreur;
+        pthread_mutex_unlock(&lecteur->verrou);
+
+        if (erreur)
+            return -1;
+        if (lignes == 0)
+            return 0;
+
+        // the filters only look at one pixel at a time, a band is filtered as an image of its own
+        entete->bitmap.hauteur = lignes;
+        if (format_image(entete) != FORMAT_PALETTE_8)
+            executer_chaine(chaine, entete, lecteur->tampons[tampon], lecteur->taille_ligne);
+
+        // the kept columns are gathered from the band without being copied
+        entete_sortie->bitmap.hauteur = lignes;
+        if (ecrire_lignes(fd_sortie, lecteur->tampons[tampon] + (size_t) colonne * octets_par_pixel(entete),
+                          lecteur->taille_ligne,
+                          entete_sortie) == -1)
+            return -1;
+
+        // give the buffer back to the reader
+        pthread_mutex_lock(&lecteur->verrou);
+        lecteur->plein[tampon] = 0;
+        pthread_cond_broadcast(&lecteur->condition);
+        pthread_mutex_unlock(&lecteur->verrou);
+    }
+}
+
+/**
+ * @brief Modifies a BMP file band by band with bounded memory.
+ *
+ * @param entree Path of the input image.
+ * @param sortie Path of the output image.
+ * @param options The filter options, in command-line order. OPTION_FLUX itself is ignored.
+ * @param nb_options The number of options.
+ * @return 0 on success, -1 on error.
+ */
+int modif_bmp_flux(const char *entree, const char *sortie, char **options, int nb_options)
+{
+    // the point operations are compiled once, the geometric options commute with them
+    chaine_ponctuelle chaine = {0};
+    for (int i = 0; i < nb_options; i++)
+    {
+        if (strcmp(options[i], OPTION_ROGNER) == 0)
+        {
+            i++;  // the rectangle is checked by fenetre_conservee
+        } else if (arguments_operation(options[i]) != -1)
+        {
+            int consommees = compiler_chaine(&chaine, options + i, nb_options - i);
+            if (consommees == -1)
+            {
+                printf("Error: Invalid point operation in the options starting at %s\n", options[i]);
+                liberer_chaine(&chaine);
+                return -1;
+            }
+            i += consommees - 1;
+        } else if (strcmp(options[i], OPTION_FLUX) != 0 && strcmp(options[i], "-s") != 0
+                   && strcmp(options[i], "-i") != 0)
+        {
+            printf("Error: Option %s is not supported in streaming mode\n", options[i]);
+            liberer_chaine(&chaine);
+            return -1;
+        }
+    }
+
+    int fd_entree = open(entree, O_RDONLY);
+    if (fd_entree == -1)
+    {
+        printf("Error: Cannot open input file %s\n", entree);
+        liberer_chaine(&chaine);
+        return -1;
+    }
+
+    entete_bmp entete;
+    if (lire_entete(fd_entree, &entete) == -1 || !verifier_entete(&entete))
+    {
+        printf("Error: Cannot read a supported BMP header from input file %s\n", entree);
+        close(fd_entree);
+        liberer_chaine(&chaine);
+        return -1;
+    }
+
+    // the geometric options only select a window, the rows outside of it are never read
+    uint32_t colonne, premiere, largeur, nombre;
+    if (fenetre_conservee(&entete, options, nb_options, &colonne, &premiere, &largeur, &nombre) == -1)
+    {
+        printf("Error: %s expects a rectangle x,y,w,h inside the image\n", OPTION_ROGNER);
+        close(fd_entree);
+        liberer_chaine(&chaine);
+        return -1;
+    }
+
+    lecteur_flux lecteur = {0};
+    lecteur.fd = fd_entree;
+    lecteur.taille_ligne = taille_ligne(&entete);
+    lecteur.lignes_restantes = nombre;
+    lecteur.lignes_par_bande = TAILLE_BANDE_FLUX / lecteur.taille_ligne;
+    if (lecteur.lignes_par_bande == 0)
+        lecteur.lignes_par_bande = 1;
+    if (lecteur.lignes_par_bande > nombre && nombre > 0)
+        lecteur.lignes_par_bande = nombre;
+
+    entete_bmp entete_sortie = entete;
+    entete_sortie.bitmap.largeur = largeur;
+    entete_sortie.bitmap.hauteur = nombre;
+    ajuster_tailles(&entete_sortie);
+
+    // paletted images are filtered once through their palette, which is written with the header
+    if (format_image(&entete) == FORMAT_PALETTE_8)
+        executer_chaine(&chaine, &entete_sortie, NULL, 0);
+
+    int fd_sortie = open(sortie, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_sortie == -1)
+    {
+        printf("Error: Cannot open output file %s\n", sortie);
+        close(fd_entree);
+        liberer_chaine(&chaine);
+        return -1;
+    }
+
+    if (ecrire_entete(fd_sortie, &entete_sortie) == -1
+        || lseek(fd_sortie, entete.fichier.offset_donnees, SEEK_SET) == (off_t) -1
+        || lseek(fd_entree, entete.fichier.offset_donnees + (off_t) premiere * lecteur.taille_ligne, SEEK_SET) == (off_t) -1)
+    {
+        printf("Error: Cannot write BMP header to output file %s\n", sortie);
+        close(fd_entree);
+        close(fd_sortie);
+        liberer_chaine(&chaine);
+        return -1;
+    }
+
+    lecteur.tampons[0] = malloc(lecteur.lignes_par_bande * lecteur.taille_ligne);
+    lecteur.tampons[1] = malloc(lecteur.lignes_par_bande * lecteur.taille_ligne);
+    if (!lecteur.tampons[0] || !lecteur.tampons[1])
+    {
+        printf("Error: Cannot allocate the band buffers\n");
+        free(lecteur.tampons[0]);
+        free(lecteur.tampons[1]);
+        close(fd_entree);
+        close(fd_sortie);
+        liberer_chaine(&chaine);
+        return -1;
+    }
+
+    pthread_mutex_init(&lecteur.verrou, NULL);
+    pthread_cond_init(&lecteur.condition, NULL);
+
+    int resultat = -1;
+    pthread_t thread_lecture;
+    if (pthread_create(&thread_lecture, NULL, lire_bandes, &lecteur) == 0)
+    {
+        resultat = ecrire_bandes(&lecteur, &entete, &entete_sortie, colonne, fd_sortie, &chaine);
+
+        // on error, wake the reader up so that it does not wait for a buffer forever
+        pthread_mutex_lock(&lecteur.verrou);
+        lecteur.arret = 1;
+        pthread_cond_broadcast(&lecteur.condition);
+        pthread_mutex_unlock(&lecteur.verrou);
+        pthread_join(thread_lecture, NULL);
+    }
+
+    pthread_cond_destroy(&lecteur.condition);
+    pthread_mutex_destroy(&lecteur.verrou);
+    liberer_chaine(&chaine);
+    free(lecteur.tampons[0]);
+    free(lecteur.tampons[1]);
+    close(fd_entree);
+    close(fd_sortie);
+
+    if (resultat == -1)
+    {
+        printf("Error: Cannot stream pixel data from %s to %s\n", entree, sortie);
+        return -1;
+    }
+
+    return 0;
+}
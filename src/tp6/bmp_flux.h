@@ -0,0 +1,74 @@
+/**
+ * @file bmp_flux.h
+ * @brief Streaming mode of the BMP modification tool.
+ *
+ * Processes images band by band so that images larger than the available memory can be modified.
+ */
+
+#ifndef R305_BMP_FLUX_H
+#define R305_BMP_FLUX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "modif_bmp.h"
+
+/// Option of --modif_bmp selecting the streaming mode
+#define OPTION_FLUX "--stream"
+
+/// Target size in bytes of one band of rows; two bands are in memory at any time
+#define TAILLE_BANDE_FLUX (4 * 1024 * 1024)
+
+/**
+ * @brief State shared between the reader thread and the thread filtering and writing the bands.
+ *
+ * The two buffers are used alternately: while band N is filtered and written from one of them,
+ * the reader thread fills the other one with band N + 1.
+ */
+typedef struct
+{
+    int fd;                      ///< file descriptor of the input image, positioned on the first row
+    size_t taille_ligne;         ///< size of a row, padding included
+    uint32_t lignes_restantes;   ///< rows the reader still has to read
+    uint32_t lignes_par_bande;   ///< maximum number of rows of a band
+    unsigned char *tampons[2];   ///< the two band buffers
+    uint32_t lignes[2];          ///< rows held by each buffer, 0 marks the end of the image
+    int plein[2];                ///< 1 once the reader has filled the buffer
+    int erreur;                  ///< 1 if the reader failed
+    int arret;                   ///< 1 if the writer asks the reader to stop
+    pthread_mutex_t verrou;
+    pthread_cond_t condition;
+} lecteur_flux;
+
+/**
+ * @brief Computes the part of the image kept by the geometric options (-s, -i and --crop) of a filter list.
+ *
+ * @param entete Header of the input image.
+ * @param options The filter options, in command-line order.
+ * @param nb_options The number of options.
+ * @param colonne Receives the index of the first kept column.
+ * @param premiere Receives the index of the first kept row, in file order.
+ * @param largeur Receives the number of kept columns.
+ * @param nombre Receives the number of kept rows.
+ * @return 0 on success, -1 if a --crop rectangle is malformed or outside the image.
+ */
+int fenetre_conservee(const entete_bmp *entete, char **options, int nb_options, uint32_t *colonne,
+                      uint32_t *premiere, uint32_t *largeur, uint32_t *nombre);
+
+/**
+ * @brief Modifies a BMP file band by band with bounded memory.
+ *
+ * Only point operations (see bmp_tables.h), halving (-s, -i) and cropping (--crop) are supported: they either act
+ * on one pixel at a time or only select pixels, so each band can be processed independently of the others.
+ * The image is never loaded as a whole: two bands of about TAILLE_BANDE_FLUX bytes are allocated
+ * and reading the next band overlaps filtering and writing the current one.
+ *
+ * @param entree Path of the input image.
+ * @param sortie Path of the output image.
+ * @param options The filter options, in command-line order. OPTION_FLUX itself is ignored.
+ * @param nb_options The number of options.
+ * @return 0 on success, -1 on error.
+ */
+int modif_bmp_flux(const char *entree, const char *sortie, char **options, int nb_options);
+
+#endif //R305_BMP_FLUX_H
@@ -0,0 +1,168 @@
+/**
+ * @file bmp_geometrie.c
+ * @brief Rotations and mirrors of images for the BMP modification tool.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "bmp_geometrie.h"
+
+/**
+ * @brief Mirrors a view of an image left to right, in place.
+ *
+ * Pixels of every format, palette indices included, are moved as a whole, so the same swap works for all of them.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows, negative if the view is upside down.
+ */
+void miroir_horizontal(const entete_bmp *entete, unsigned char *pixels, ptrdiff_t pas)
+{
+    uint32_t octets = octets_par_pixel(entete);
+    uint32_t largeur = entete->bitmap.largeur;
+
+    for (uint32_t line = 0; line < entete->bitmap.hauteur; line++)
+    {
+        unsigned char *gauche = pixels + line * pas;
+        unsigned char *droite = gauche + (size_t) (largeur - 1) * octets;
+
+        for (; gauche < droite; gauche += octets, droite -= octets)
+        {
+            unsigned char pixel[4];
+            memcpy(pixel, gauche, octets);
+            memcpy(gauche, droite, octets);
+            memcpy(droite, pixel, octets);
+        }
+    }
+}
+
+/**
+ * @brief Mirrors a view of an image top to bottom without moving any pixel.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Pointer to the number of bytes between two consecutive rows, negated.
+ * @return Pointer to the first row of the mirrored view, which is the last row of the view.
+ */
+unsigned char *miroir_vertical(const entete_bmp *entete, unsigned char *pixels, ptrdiff_t *pas)
+{
+    uint32_t hauteur = entete->bitmap.hauteur;
+    unsigned char *derniere = hauteur > 0 ? pixels + (hauteur - 1) * *pas : pixels;
+
+    *pas = -*pas;
+    return derniere;
+}
+
+/// Copies a block of pixels of `octets` bytes to its transposed position, the size being known at compile time
+#define COPIER_BLOC(octets) \
+    for (uint32_t line = 0; line < hauteur; line++) \
+    { \
+        for (uint32_t col = 0; col < largeur; col++) \
+        { \
+            memcpy(destination + col * pas_destination + line * (octets), \
+                   source + line * pas_source + col * (octets), (octets)); \
+        } \
+    }
+
+/**
+ * @brief Copies the pixel of row r and column c of the source to row c and column r of the destination.
+ *
+ * The block is cut in two along its longer side until both sides are at most TAILLE_BLOC_ROTATION, whatever
+ * the cache sizes: at some depth of the recursion the rows read and written by a block fit in each level of
+ * the cache, so that every cache line loaded is fully used before being evicted.
+ *
+ * @param source Pointer to the first row of the source block.
+ * @param pas_source Number of bytes between two consecutive rows of the source, may be negative.
+ * @param destination Pointer to the first row of the destination block.
+ * @param pas_destination Number of bytes between two consecutive rows of the destination, may be negative.
+ * @param largeur Width of the source block.
+ * @param hauteur Height of the source block.
+ * @param octets Size of a pixel, 1 to 4 bytes.
+ */
+static void transposer_bloc(const unsigned char *source, ptrdiff_t pas_source, unsigned char *destination,
+                            ptrdiff_t pas_destination, uint32_t largeur, uint32_t hauteur, uint32_t octets)
+{
+    if (largeur > TAILLE_BLOC_ROTATION && largeur >= hauteur)
+    {
+        uint32_t moitie = largeur / 2;
+        transposer_bloc(source, pas_source, destination, pas_destination, moitie, hauteur, octets);
+        transposer_bloc(source + (size_t) moitie * octets, pas_source, destination + moitie * pas_destination,
+                        pas_destination, largeur - moitie, hauteur, octets);
+        return;
+    }
+    if (hauteur > TAILLE_BLOC_ROTATION)
+    {
+        uint32_t moitie = hauteur / 2;
+        transposer_bloc(source, pas_source, destination, pas_destination, largeur, moitie, octets);
+        transposer_bloc(source + moitie * pas_source, pas_source, destination + (size_t) moitie * octets,
+                        pas_destination, largeur, hauteur - moitie, octets);
+        return;
+    }
+
+    switch (octets)
+    {
+        case 1:
+            COPIER_BLOC(1)
+            break;
+        case 2:
+            COPIER_BLOC(2)
+            break;
+        case 3:
+            COPIER_BLOC(3)
+            break;
+        default:
+            COPIER_BLOC(4)
+            break;
+    }
+}
+
+/**
+ * @brief Rotates a view of an image by a quarter turn into a new buffer.
+ *
+ * Rows are stored bottom-up. Turning clockwise, the column c of the source becomes the row
+ * largeur - 1 - c of the destination; turning counterclockwise, the row r of the source becomes
+ * the column hauteur - 1 - r. Both are a transposition in which one of the two views walks its
+ * rows backwards.
+ *
+ * @param entete Pointer to the header describing the view, updated with the swapped dimensions.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows, negative if the view is upside down.
+ * @param angle The clockwise angle, 90 or 270.
+ * @return The allocated pixels of the rotated image, rows padded as in a file, or NULL on error
+ *         (invalid angle or allocation failure). The header is unchanged on error.
+ */
+unsigned char *pivoter(entete_bmp *entete, const unsigned char *pixels, ptrdiff_t pas, int angle)
+{
+    uint32_t largeur = entete->bitmap.largeur, hauteur = entete->bitmap.hauteur;
+
+    if ((angle != 90 && angle != 270) || largeur == 0 || hauteur == 0)
+        return NULL;
+
+    entete_bmp resultat = *entete;
+    resultat.bitmap.largeur = hauteur;
+    resultat.bitmap.hauteur = largeur;
+    resultat.bitmap.resolution_horizontale = entete->bitmap.resolution_verticale;
+    resultat.bitmap.resolution_verticale = entete->bitmap.resolution_horizontale;
+    ajuster_tailles(&resultat);
+
+    // the padding of the rows is written as is, it must not hold garbage
+    unsigned char *sortie = calloc(taille_pixels(&resultat), 1);
+    if (!sortie)
+        return NULL;
+
+    ptrdiff_t pas_sortie = (ptrdiff_t) taille_ligne(&resultat);
+    unsigned char *destination = sortie;
+    if (angle == 90)
+    {
+        destination += (largeur - 1) * pas_sortie;
+        pas_sortie = -pas_sortie;
+    } else
+    {
+        pixels += (hauteur - 1) * pas;
+        pas = -pas;
+    }
+
+    transposer_bloc(pixels, pas, destination, pas_sortie, largeur, hauteur, octets_par_pixel(entete));
+    *entete = resultat;
+    return sortie;
+}
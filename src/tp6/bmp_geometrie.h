@@ -0,0 +1,60 @@
+/**
+ * @file bmp_geometrie.h
+ * @brief Rotations and mirrors of images for the BMP modification tool.
+ *
+ * A vertical mirror never moves a pixel: the view starts at its last row and walks the rows backwards,
+ * which the output follows when it gathers the rows. A horizontal mirror swaps the pixels of each row in
+ * place. Rotations by a quarter turn transpose the pixels into a new buffer.
+ */
+
+#ifndef R305_BMP_GEOMETRIE_H
+#define R305_BMP_GEOMETRIE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "modif_bmp.h"
+
+/// Option of --modif_bmp rotating the image clockwise, followed by the angle: 90, 180 or 270
+#define OPTION_PIVOTER "--rotate"
+
+/// Option of --modif_bmp mirroring the image left to right
+#define OPTION_MIROIR_HORIZONTAL "--flip-h"
+
+/// Option of --modif_bmp mirroring the image top to bottom
+#define OPTION_MIROIR_VERTICAL "--flip-v"
+
+/// Side in pixels under which the transposition stops splitting a block and copies it
+#define TAILLE_BLOC_ROTATION 16
+
+/**
+ * @brief Mirrors a view of an image left to right, in place.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows, negative if the view is upside down.
+ */
+void miroir_horizontal(const entete_bmp *entete, unsigned char *pixels, ptrdiff_t pas);
+
+/**
+ * @brief Mirrors a view of an image top to bottom without moving any pixel.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Pointer to the number of bytes between two consecutive rows, negated.
+ * @return Pointer to the first row of the mirrored view, which is the last row of the view.
+ */
+unsigned char *miroir_vertical(const entete_bmp *entete, unsigned char *pixels, ptrdiff_t *pas);
+
+/**
+ * @brief Rotates a view of an image by a quarter turn into a new buffer.
+ *
+ * @param entete Pointer to the header describing the view, updated with the swapped dimensions.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows, negative if the view is upside down.
+ * @param angle The clockwise angle, 90 or 270.
+ * @return The allocated pixels of the rotated image, rows padded as in a file, or NULL on error
+ *         (invalid angle or allocation failure). The header is unchanged on error.
+ */
+unsigned char *pivoter(entete_bmp *entete, const unsigned char *pixels, ptrdiff_t pas, int angle);
+
+#endif //R305_BMP_GEOMETRIE_H
@@ -0,0 +1,405 @@
+/**
+ * @file bmp_lot.c
+ * @brief Batch mode of the BMP modification tool.
+ *
+ * A fixed pool of threads takes the images of the batch one after the other, so that a directory of
+ * thousands of images costs neither a process nor a pixel allocation per image.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "bmp_lot.h"
+
+/**
+ * @brief Compares two paths for qsort.
+ */
+static int comparer_chemins(const void *a, const void *b)
+{
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+/**
+ * @brief Compares two jobs by output path for qsort.
+ */
+static int comparer_sorties(const void *a, const void *b)
+{
+    return strcmp((*(travail_bmp *const *) a)->sortie, (*(travail_bmp *const *) b)->sortie);
+}
+
+/**
+ * @brief Prints the usage of the batch mode.
+ */
+static void afficher_usage(void)
+{
+    printf("Error: Usage: --modif_bmp %s <directory|list> <output directory> [%s threads] [%s] [filters...]\n",
+           OPTION_LOT, OPTION_TRAVAILLEURS, OPTION_FLUX);
+}
+
+/**
+ * @brief Appends a path to a growing array of paths.
+ *
+ * @param chemins The array of paths.
+ * @param nb The number of paths in the array.
+ * @param capacite The allocated size of the array.
+ * @param chemin The path to copy at the end of the array.
+ * @return 0 on success, -1 if memory allocation failed.
+ */
+static int ajouter_chemin(char ***chemins, int *nb, int *capacite, const char *chemin)
+{
+    if (*nb == *capacite)
+    {
+        int nouvelle_capacite = *capacite ? *capacite * 2 : 64;
+        char **tmp = realloc(*chemins, nouvelle_capacite * sizeof(char *));
+        if (!tmp)
+            return -1;
+        *chemins = tmp;
+        *capacite = nouvelle_capacite;
+    }
+
+    char *copie = malloc(strlen(chemin) + 1);
+    if (!copie)
+        return -1;
+    strcpy(copie, chemin);
+    (*chemins)[(*nb)++] = copie;
+    return 0;
+}
+
+/**
+ * @brief Lists the images of a batch.
+ *
+ * @param source Either a directory, whose `.bmp` files are listed in name order, or a text file
+ *               containing one path per line.
+ * @param chemins Receives an allocated array of allocated paths.
+ * @param nb Receives the number of paths.
+ * @return 0 on success, -1 on error.
+ */
+int lister_images(const char *source, char ***chemins, int *nb)
+{
+    struct stat infos;
+    int capacite = 0;
+    int erreur = 0;
+
+    *chemins = NULL;
+    *nb = 0;
+
+    if (stat(source, &infos) == -1)
+        return -1;
+
+    if (S_ISDIR(infos.st_mode))
+    {
+        DIR *dossier = opendir(source);
+        if (!dossier)
+            return -1;
+
+        struct dirent *entree;
+        while (!erreur && (entree = readdir(dossier)) != NULL)
+        {
+            size_t longueur = strlen(entree->d_name);
+            if (longueur < 4 || strcasecmp(entree->d_name + longueur - 4, ".bmp") != 0)
+                continue;
+
+            char chemin[strlen(source) + longueur + 2];
+            sprintf(chemin, "%s/%s", source, entree->d_name);
+            erreur = ajouter_chemin(chemins, nb, &capacite, chemin);
+        }
+        closedir(dossier);
+
+        // readdir gives no order, the batch is processed and reported in name order
+        if (!erreur && *nb > 1)
+            qsort(*chemins, *nb, sizeof(char *), comparer_chemins);
+    } else
+    {
+        FILE *liste = fopen(source, "r");
+        if (!liste)
+            return -1;
+
+        char *ligne = NULL;
+        size_t taille = 0;
+        ssize_t longueur;
+        while (!erreur && (longueur = getline(&ligne, &taille, liste)) != -1)
+        {
+            while (longueur > 0 && (ligne[longueur - 1] == '\n' || ligne[longueur - 1] == '\r'))
+                ligne[--longueur] = '\0';
+            if (longueur > 0)
+                erreur = ajouter_chemin(chemins, nb, &capacite, ligne);
+        }
+        free(ligne);
+        fclose(liste);
+    }
+
+    if (erreur)
+    {
+        for (int i = 0; i < *nb; i++)
+            free((*chemins)[i]);
+        free(*chemins);
+        *chemins = NULL;
+        *nb = 0;
+    }
+
+    return erreur;
+}
+
+/**
+ * @brief Returns the current time of the monotonic clock in seconds.
+ */
+static double maintenant(void)
+{
+    struct timespec temps;
+    clock_gettime(CLOCK_MONOTONIC, &temps);
+    return temps.tv_sec + temps.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Reads the header of a BMP file.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int lire_entete_fichier(const char *chemin, entete_bmp *entete)
+{
+    int fd = open(chemin, O_RDONLY);
+    if (fd == -1)
+        return -1;
+    int resultat = lire_entete(fd, entete);
+    close(fd);
+    return resultat;
+}
+
+/**
+ * @brief Body of a worker thread.
+ *
+ * Takes jobs until the queue of the batch is closed and empty, reading every image into the same buffer, or
+ * streaming it band by band when the batch asks for OPTION_FLUX.
+ *
+ * @param argument Pointer to the lot_bmp shared by the workers.
+ * @return NULL
+ */
+static void *travailleur(void *argument)
+{
+    lot_bmp *lot = argument;
+    tampon_pixels tampon = {NULL, 0};
+
+    element_t indice;
+    while (file_mpmc_defiler(&lot->prets, &indice) == 0)
+    {
+        travail_bmp *travail = &lot->travaux[indice];
+        entete_bmp entete;
+        double debut = maintenant();
+
+        if (lot->flux)
+        {
+            travail->resultat = modif_bmp_flux(travail->entree, travail->sortie, lot->options, lot->nb_options);
+            travail->duree = maintenant() - debut;
+            // the streaming mode keeps the header to itself, it is read again for the summary
+            if (travail->resultat == 0 && lire_entete_fichier(travail->entree, &entete) == -1)
+                travail->resultat = -1;
+        } else
+        {
+            travail->resultat = modifier_bmp(travail->entree, travail->sortie, lot->options, lot->nb_options,
+                                             &tampon, &entete);
+            travail->duree = maintenant() - debut;
+        }
+        travail->pixels = travail->resultat == 0 ? (uint64_t) entete.bitmap.largeur * entete.bitmap.hauteur : 0;
+    }
+
+    liberer_pixels(&tampon);
+    return NULL;
+}
+
+/**
+ * @brief Prints the per-file and aggregate throughput of a batch.
+ *
+ * @param lot The processed batch.
+ * @param duree Wall-clock duration of the whole batch in seconds.
+ * @param nb_threads The number of worker threads.
+ * @return The number of images that could not be modified.
+ */
+static int afficher_bilan(const lot_bmp *lot, double duree, int nb_threads)
+{
+    uint64_t pixels = 0;
+    int echecs = 0;
+
+    for (int i = 0; i < lot->nb_travaux; i++)
+    {
+        const travail_bmp *travail = &lot->travaux[i];
+        if (travail->resultat == -1)
+        {
+            printf("%-50s failed\n", travail->entree);
+            echecs++;
+            continue;
+        }
+
+        double mpix = travail->pixels / 1e6;
+        printf("%-50s %10.2f ms %8.2f MPix %10.2f MPix/s\n", travail->entree, travail->duree * 1e3, mpix,
+               travail->duree > 0 ? mpix / travail->duree : 0);
+        pixels += travail->pixels;
+    }
+
+    printf("%d images (%d failed) on %d threads in %.3f s: %.2f MPix, %.2f MPix/s, %.1f images/s\n",
+           lot->nb_travaux, echecs, nb_threads, duree, pixels / 1e6, duree > 0 ? pixels / 1e6 / duree : 0,
+           duree > 0 ? (lot->nb_travaux - echecs) / duree : 0);
+
+    return echecs;
+}
+
+/**
+ * @brief Runs the batch mode.
+ *
+ * @param argc The number of arguments, OPTION_LOT included.
+ * @param argv The arguments, starting with OPTION_LOT.
+ * @return 0 if every image was modified, -1 otherwise.
+ */
+int run_modif_bmp_lot(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        afficher_usage();
+        return -1;
+    }
+
+    const char *source = argv[1];
+    const char *destination = argv[2];
+
+    // the number of workers and the streaming mode are not filters, they are removed from the options given to
+    // modifier_bmp or modif_bmp_flux
+    long nb_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    char **options = malloc(argc * sizeof(char *));
+    int nb_options = 0, flux = 0;
+    if (!options)
+        return -1;
+    for (int i = 3; i < argc; i++)
+    {
+        if (strcmp(argv[i], OPTION_TRAVAILLEURS) == 0)
+        {
+            // the number of threads must be a whole positive number, not a filter nor a typo run on 1 thread
+            char *fin = NULL;
+            errno = 0;
+            if (i + 1 < argc)
+                nb_threads = strtol(argv[++i], &fin, 10);
+            if (!fin || fin == argv[i] || *fin != '\0' || errno == ERANGE || nb_threads < 1)
+            {
+                afficher_usage();
+                free(options);
+                return -1;
+            }
+        } else if (strcmp(argv[i], OPTION_FLUX) == 0)
+            flux = 1;
+        else
+            options[nb_options++] = argv[i];
+    }
+    if (nb_threads < 1)
+        nb_threads = 1;
+
+    char **chemins;
+    int nb_chemins;
+    if (lister_images(source, &chemins, &nb_chemins) == -1)
+    {
+        printf("Error: Cannot list the images of %s\n", source);
+        free(options);
+        return -1;
+    }
+
+    lot_bmp lot = {0};
+    lot.travaux = calloc(nb_chemins ? nb_chemins : 1, sizeof(travail_bmp));
+    lot.nb_travaux = nb_chemins;
+    lot.options = options;
+    lot.nb_options = nb_options;
+    lot.flux = flux;
+
+    int resultat = lot.travaux ? 0 : -1;
+    int file_prete = resultat == 0 && file_mpmc_initialiser(&lot.prets, nb_chemins) == 0;
+    if (!file_prete)
+        resultat = -1;
+    if (mkdir(destination, 0755) == -1 && errno != EEXIST)
+    {
+        printf("Error: Cannot create output directory %s\n", destination);
+        resultat = -1;
+    }
+
+    for (int i = 0; resultat == 0 && i < nb_chemins; i++)
+    {
+        const char *nom = strrchr(chemins[i], '/');
+        nom = nom ? nom + 1 : chemins[i];
+
+        lot.travaux[i].entree = chemins[i];
+        lot.travaux[i].sortie = malloc(strlen(destination) + strlen(nom) + 2);
+        if (!lot.travaux[i].sortie)
+        {
+            lot.nb_travaux = i;
+            resultat = -1;
+            break;
+        }
+        sprintf(lot.travaux[i].sortie, "%s/%s", destination, nom);
+    }
+
+    // images of a list with the same name would be written at the same time to the same output file
+    travail_bmp **par_sortie = resultat == 0 ? malloc((nb_chemins ? nb_chemins : 1) * sizeof(travail_bmp *)) : NULL;
+    if (resultat == 0 && !par_sortie)
+        resultat = -1;
+    if (par_sortie)
+    {
+        for (int i = 0; i < nb_chemins; i++)
+            par_sortie[i] = &lot.travaux[i];
+        qsort(par_sortie, nb_chemins, sizeof(travail_bmp *), comparer_sorties);
+        for (int i = 1; i < nb_chemins; i++)
+        {
+            if (strcmp(par_sortie[i - 1]->sortie, par_sortie[i]->sortie) == 0)
+            {
+                printf("Error: %s and %s would both be written to %s\n", par_sortie[i - 1]->entree,
+                       par_sortie[i]->entree, par_sortie[i]->sortie);
+                resultat = -1;
+            }
+        }
+        free(par_sortie);
+    }
+
+    // the queue holds every job, so that it is filled and closed before any worker starts
+    for (int i = 0; resultat == 0 && i < lot.nb_travaux; i++)
+        file_mpmc_enfiler(&lot.prets, i);
+    if (file_prete)
+        file_mpmc_fermer(&lot.prets);
+
+    if (nb_threads > lot.nb_travaux)
+        nb_threads = lot.nb_travaux > 0 ? lot.nb_travaux : 1;
+
+    if (resultat == 0 && lot.nb_travaux > 0)
+    {
+        pthread_t threads[nb_threads];
+        long lances = 0;
+        double debut = maintenant();
+
+        for (; lances < nb_threads; lances++)
+        {
+            if (pthread_create(&threads[lances], NULL, travailleur, &lot) != 0)
+                break;
+        }
+        if (lances == 0)
+            travailleur(&lot);  // no thread could be created, the batch runs in the calling thread
+        for (long i = 0; i < lances; i++)
+            pthread_join(threads[i], NULL);
+
+        if (afficher_bilan(&lot, maintenant() - debut, lances ? lances : 1) > 0)
+            resultat = -1;
+    }
+
+    if (file_prete)
+        file_mpmc_detruire(&lot.prets);
+    for (int i = 0; i < nb_chemins; i++)
+    {
+        if (lot.travaux)
+            free(lot.travaux[i].sortie);
+        free(chemins[i]);
+    }
+    free(chemins);
+    free(lot.travaux);
+    free(options);
+
+    return resultat;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file bmp_lot.h
+ * @brief Batch mode of the BMP modification tool.
+ *
+ * Applies the same filters to many images in a single process, on a pool of worker threads.
+ */
+
+#ifndef R305_BMP_LOT_H
+#define R305_BMP_LOT_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include "modif_bmp.h"
+#include "bmp_flux.h"
+#include "../tp1/file_mpmc.h"
+
+/// First argument of --modif_bmp selecting the batch mode
+#define OPTION_LOT "--batch"
+
+/// Option of the batch mode setting the number of worker threads
+#define OPTION_TRAVAILLEURS "-j"
+
+/// One image to process and the measures taken while processing it
+typedef struct
+{
+    char *entree;      ///< path of the input image
+    char *sortie;      ///< path of the output image
+    int resultat;      ///< 0 on success, -1 on error
+    uint64_t pixels;   ///< number of pixels of the input image
+    double duree;      ///< processing time in seconds
+} travail_bmp;
+
+/// The jobs of a batch, handed out to the workers in order
+typedef struct
+{
+    travail_bmp *travaux;
+    int nb_travaux;
+    file_mpmc_t prets;        ///< indices of the jobs not handed out yet, closed once they are all in
+    char **options;           ///< filter options applied to every image
+    int nb_options;
+    int flux;                 ///< 1 if every image is modified band by band, as OPTION_FLUX asks
+} lot_bmp;
+
+/**
+ * @brief Lists the images of a batch.
+ *
+ * @param source Either a directory, whose `.bmp` files are listed in name order, or a text file
+ *               containing one path per line.
+ * @param chemins Receives an allocated array of allocated paths.
+ * @param nb Receives the number of paths.
+ * @return 0 on success, -1 on error.
+ */
+int lister_images(const char *source, char ***chemins, int *nb);
+
+/**
+ * @brief Runs the batch mode.
+ *
+ * Usage: --modif_bmp --batch <directory|list> <output directory> [-j threads] [--stream] [filters...]
+ *
+ * Every image is written to the output directory under its own name, so a list naming two images with the
+ * same file name is rejected. The number of threads must be a positive integer. Each worker keeps its pixel
+ * buffer from one image to the next, or, with OPTION_FLUX, modifies every image band by band with bounded
+ * memory. A per-file and aggregate throughput summary is printed at the end.
+ *
+ * @param argc The number of arguments, OPTION_LOT included.
+ * @param argv The arguments, starting with OPTION_LOT.
+ * @return 0 if every image was modified, -1 otherwise.
+ */
+int run_modif_bmp_lot(int argc, char *argv[]);
+
+#endif //R305_BMP_LOT_H
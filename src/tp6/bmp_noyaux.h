@@ -0,0 +1,111 @@
+/**
+ * @file bmp_noyaux.h
+ * @brief Generators of per-format pixel kernels for the BMP modification tool.
+ *
+ * A point filter is written once as a body working on `x`, a pointer to the blue, green and red bytes
+ * of the current pixel, and on `contexte`, an optional pointer to the parameters of the filter. DEFINIR_NOYAUX instantiates that body for every supported pixel format, with the
+ * pixel size known at compile time so that each variant is a plain loop the compiler can unroll.
+ */
+
+#ifndef R305_BMP_NOYAUX_H
+#define R305_BMP_NOYAUX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "modif_bmp.h"
+
+/// Expands a channel of `bits` bits to 8 bits, replicating its high bits in the low ones
+#define ETENDRE_CANAL(valeur, bits) ((unsigned char) (((valeur) << (8 - (bits))) | ((valeur) >> (2 * (bits) - 8))))
+
+/**
+ * @brief Defines `nom_<octets>`, the variant of a kernel for pixels of `octets` bytes stored as blue, green, red.
+ *
+ * The kernel walks `hauteur` rows of `largeur` pixels, consecutive rows being `pas` bytes apart.
+ */
+#define DEFINIR_NOYAU(nom, octets, ...) \
+    static void nom##_##octets(unsigned char *pixels, uint32_t largeur, uint32_t hauteur, size_t pas, \
+                               const void *contexte) \
+    { \
+        (void) contexte; \
+        for (uint32_t line = 0; line < hauteur; line++) \
+        { \
+            unsigned char *lineoff = pixels + line * pas; \
+            for (uint32_t col = 0; col < largeur; col++) \
+            { \
+                unsigned char *x = lineoff + col * (octets); \
+                __VA_ARGS__ \
+            } \
+        } \
+    }
+
+/**
+ * @brief Defines `nom_<suffixe>`, the variant of a kernel for 16-bit pixels with a green channel of `bits_vert` bits.
+ *
+ * Each pixel is expanded to 8-bit channels, filtered and packed again. Unused high bits are preserved.
+ */
+#define DEFINIR_NOYAU_16(nom, suffixe, bits_vert, ...) \
+    static void nom##_##suffixe(unsigned char *pixels, uint32_t largeur, uint32_t hauteur, size_t pas, \
+                                const void *contexte) \
+    { \
+        (void) contexte; \
+        for (uint32_t line = 0; line < hauteur; line++) \
+        { \
+            unsigned char *lineoff = pixels + line * pas; \
+            for (uint32_t col = 0; col < largeur; col++) \
+            { \
+                unsigned char *p = lineoff + col * 2; \
+                uint16_t valeur = p[0] | p[1] << 8; \
+                unsigned char x[3] = { \
+                    ETENDRE_CANAL(valeur & 0x1F, 5), \
+                    ETENDRE_CANAL((valeur >> 5) & ((1 << (bits_vert)) - 1), bits_vert), \
+                    ETENDRE_CANAL((valeur >> (5 + (bits_vert))) & 0x1F, 5)}; \
+                __VA_ARGS__ \
+                valeur = (valeur & ~((1 << (10 + (bits_vert))) - 1)) | x[0] >> 3 \
+                         | (x[1] >> (8 - (bits_vert))) << 5 | (x[2] >> 3) << (5 + (bits_vert)); \
+                p[0] = valeur & 0xFF; \
+                p[1] = valeur >> 8; \
+            } \
+        } \
+    }
+
+/**
+ * @brief Defines every format variant of a point filter and `nom_vue`, which dispatches on the format of an image.
+ *
+ * Paletted images are filtered through their palette: its entries are blue, green, red, reserved quadruplets,
+ * so the palette is filtered as a single row of 32-bit pixels and the pixel indices are never touched.
+ */
+#define DEFINIR_NOYAUX(nom, ...) \
+    DEFINIR_NOYAU(nom, 3, __VA_ARGS__) \
+    DEFINIR_NOYAU(nom, 4, __VA_ARGS__) \
+    DEFINIR_NOYAU_16(nom, 555, 5, __VA_ARGS__) \
+    DEFINIR_NOYAU_16(nom, 565, 6, __VA_ARGS__) \
+    static void nom##_vue(entete_bmp *entete, unsigned char *pixels, size_t pas, const void *contexte) \
+    { \
+        uint32_t largeur = entete->bitmap.largeur; \
+        uint32_t hauteur = entete->bitmap.hauteur; \
+        uint32_t couleurs; \
+        unsigned char *palette; \
+        switch (format_image(entete)) \
+        { \
+            case FORMAT_BGR_24: \
+                nom##_3(pixels, largeur, hauteur, pas, contexte); \
+                break; \
+            case FORMAT_BGRA_32: \
+                nom##_4(pixels, largeur, hauteur, pas, contexte); \
+                break; \
+            case FORMAT_RGB_555: \
+                nom##_555(pixels, largeur, hauteur, pas, contexte); \
+                break; \
+            case FORMAT_RGB_565: \
+                nom##_565(pixels, largeur, hauteur, pas, contexte); \
+                break; \
+            case FORMAT_PALETTE_8: \
+                palette = palette_image(entete, &couleurs); \
+                nom##_4(palette, couleurs, 1, (size_t) couleurs * 4, contexte); \
+                break; \
+            default: \
+                break; \
+        } \
+    }
+
+#endif //R305_BMP_NOYAUX_H
@@ -0,0 +1,277 @@
+/**
+ * @file bmp_redimension.c
+ * @brief Resampling of images to arbitrary dimensions for the BMP modification tool.
+ *
+ * Both passes accumulate pixels widened to four single-precision lanes, so that a weighted pixel is
+ * added to the sum of all its channels with one vector multiplication and one vector addition.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include "bmp_redimension.h"
+#include "bmp_simd.h"
+#include "../commun/arene.h"
+
+/**
+ * @brief Reads the argument of OPTION_REDIMENSIONNER.
+ *
+ * @param argument The argument, of the form WxH, WxH:area or WxH:lanczos.
+ * @param largeur Receives the width.
+ * @param hauteur Receives the height.
+ * @param mode Receives the filter, REDIMENSION_AIRE by default.
+ * @return 0 on success, -1 if the argument is malformed.
+ */
+int lire_dimensions(const char *argument, uint32_t *largeur, uint32_t *hauteur, mode_redimension *mode)
+{
+    char filtre[16] = "area";
+    char fin;
+    int lus;
+
+    if (argument == NULL)
+        return -1;
+
+    lus = sscanf(argument, "%" SCNu32 "x%" SCNu32 ":%15[a-z]%c", largeur, hauteur, filtre, &fin);
+    if (lus != 2 && lus != 3)
+        return -1;
+    if (lus == 2 && strchr(argument, ':') != NULL)
+        return -1;
+
+    if (strcmp(filtre, "area") == 0)
+        *mode = REDIMENSION_AIRE;
+    else if (strcmp(filtre, "lanczos") == 0)
+        *mode = REDIMENSION_LANCZOS;
+    else
+        return -1;
+
+    return 0;
+}
+
+/**
+ * @brief The Lanczos kernel, sinc(x) * sinc(x / LOBES_LANCZOS) on ]-LOBES_LANCZOS, LOBES_LANCZOS[.
+ */
+static double lanczos(double x)
+{
+    if (x == 0)
+        return 1;
+    if (x <= -LOBES_LANCZOS || x >= LOBES_LANCZOS)
+        return 0;
+
+    // M_PI is not part of C11
+    double pi_x = 3.14159265358979323846 * x;
+    return LOBES_LANCZOS * sin(pi_x) * sin(pi_x / LOBES_LANCZOS) / (pi_x * pi_x);
+}
+
+/**
+ * @brief Computes the weights resampling an axis of `source` pixels to `destination` pixels.
+ *
+ * Output pixel i covers the input interval [i * echelle, (i + 1) * echelle[. In area mode its weights
+ * are the lengths of the overlaps of that interval with the input pixels. In Lanczos mode the kernel is
+ * centred on the middle of the interval and, when shrinking, stretched by the scale so that it also
+ * filters out the frequencies the output cannot represent. Input pixels outside the image are dropped
+ * and the remaining weights normalised.
+ *
+ * @param banque The filter bank to fill, to be freed with liberer_banque.
+ * @param source The number of input positions.
+ * @param destination The number of output positions.
+ * @param mode The filter.
+ * @return 0 on success, -1 if memory allocation failed.
+ */
+int construire_banque(banque_filtres *banque, uint32_t source, uint32_t destination, mode_redimension mode)
+{
+    double echelle = (double) source / destination;
+    double etirement = echelle > 1 ? echelle : 1;
+    double support = mode == REDIMENSION_AIRE ? echelle / 2 : LOBES_LANCZOS * etirement;
+
+    banque->taille = destination;
+    banque->prises = (uint32_t) ceil(2 * support) + 2;
+    if (banque->prises > source)
+        banque->prises = source;
+    banque->debut = malloc(destination * sizeof(uint32_t));
+    banque->nombre = malloc(destination * sizeof(uint32_t));
+    banque->poids = calloc((size_t) destination * banque->prises, sizeof(float));
+    if (!banque->debut || !banque->nombre || !banque->poids)
+    {
+        liberer_banque(banque);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < destination; i++)
+    {
+        double gauche = i * echelle, droite = (i + 1) * echelle, centre = (gauche + droite) / 2;
+        double premier = floor(centre - support), dernier = ceil(centre + support);
+        uint32_t debut = premier < 0 ? 0 : (uint32_t) premier;
+        uint32_t fin = dernier > source ? source : (uint32_t) dernier;
+        float *poids = banque->poids + (size_t) i * banque->prises;
+        double somme = 0;
+
+        if (fin - debut > banque->prises)
+            fin = debut + banque->prises;
+
+        for (uint32_t j = debut; j < fin; j++)
+        {
+            if (mode == REDIMENSION_AIRE)
+                poids[j - debut] = (float) fmax(0, fmin(j + 1, droite) - fmax(j, gauche));
+            else
+                poids[j - debut] = (float) lanczos((j + 0.5 - centre) / etirement);
+            somme += poids[j - debut];
+        }
+        for (uint32_t j = debut; somme != 0 && j < fin; j++)
+            poids[j - debut] = (float) (poids[j - debut] / somme);
+
+        banque->debut[i] = debut;
+        banque->nombre[i] = fin - debut;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Frees the arrays of a filter bank.
+ *
+ * @param banque The filter bank.
+ */
+void liberer_banque(banque_filtres *banque)
+{
+    free(banque->debut);
+    free(banque->nombre);
+    free(banque->poids);
+    banque->debut = NULL;
+    banque->nombre = NULL;
+    banque->poids = NULL;
+}
+
+/**
+ * @brief Resamples every row of an image of 4-byte pixels to the width of a filter bank.
+ *
+ * @param source The image, `hauteur` rows of `largeur` pixels.
+ * @param largeur The width of the image.
+ * @param hauteur The height of the image.
+ * @param banque The weights of the horizontal axis.
+ * @param destination Receives `hauteur` rows of `banque->taille` widened pixels.
+ */
+static void passe_horizontale(const uint32_t *source, uint32_t largeur, uint32_t hauteur,
+                              const banque_filtres *banque, v4sf *destination)
+{
+    for (uint32_t line = 0; line < hauteur; line++)
+    {
+        const uint32_t *ligne = source + (size_t) line * largeur;
+        v4sf *sortie = destination + (size_t) line * banque->taille;
+
+        for (uint32_t col = 0; col < banque->taille; col++)
+        {
+            const uint32_t *entree = ligne + banque->debut[col];
+            const float *poids = banque->poids + (size_t) col * banque->prises;
+            v4sf somme = {0, 0, 0, 0};
+
+            for (uint32_t k = 0; k < banque->nombre[col]; k++)
+                somme += poids[k] * __builtin_convertvector(charger_pixel(entree + k), v4sf);
+            sortie[col] = somme;
+        }
+    }
+}
+
+/**
+ * @brief Resamples every column of an image of widened pixels to the height of a filter bank.
+ *
+ * Each output row is the weighted sum of a few whole input rows, so memory is walked row by row
+ * and no transposition is needed.
+ *
+ * @param source The image, rows of `largeur` widened pixels.
+ * @param largeur The width of the image.
+ * @param banque The weights of the vertical axis.
+ * @param somme A buffer of `largeur` vectors accumulating the current output row.
+ * @param destination Receives `banque->taille` rows of `largeur` 4-byte pixels.
+ */
+static void passe_verticale(const v4sf *source, uint32_t largeur, const banque_filtres *banque, v4sf *somme,
+                            uint32_t *destination)
+{
+    for (uint32_t line = 0; line < banque->taille; line++)
+    {
+        const float *poids = banque->poids + (size_t) line * banque->prises;
+        uint32_t *sortie = destination + (size_t) line * largeur;
+
+        memset(somme, 0, largeur * sizeof(v4sf));
+        for (uint32_t k = 0; k < banque->nombre[line]; k++)
+        {
+            const v4sf *entree = source + (size_t) (banque->debut[line] + k) * largeur;
+            for (uint32_t col = 0; col < largeur; col++)
+                somme[col] += poids[k] * entree[col];
+        }
+
+        // the negative lobes of the Lanczos kernel may overshoot [0, 255]
+        for (uint32_t col = 0; col < largeur; col++)
+            ranger_pixel(sortie + col, saturer(__builtin_convertvector(somme[col] + 0.5f, v4si)));
+    }
+}
+
+/**
+ * @brief Resamples a view of an image to new dimensions.
+ *
+ * @param entete Pointer to the header describing the view, updated with the new dimensions and sizes.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows of the view.
+ * @param largeur The new width. If 0, it is computed from the height to keep the aspect ratio.
+ * @param hauteur The new height. If 0, it is computed from the width to keep the aspect ratio.
+ * @param mode The filter.
+ * @return The allocated pixels of the resampled image, rows padded as in a file, or NULL on error
+ *         (paletted image, invalid dimensions or allocation failure). The header is unchanged on error.
+ */
+unsigned char *redimensionner(entete_bmp *entete, const unsigned char *pixels, size_t pas, uint32_t largeur,
+                              uint32_t hauteur, mode_redimension mode)
+{
+    uint32_t largeur_source = entete->bitmap.largeur, hauteur_source = entete->bitmap.hauteur;
+
+    if (largeur_source == 0 || hauteur_source == 0 || (largeur == 0 && hauteur == 0))
+        return NULL;
+    if (largeur == 0)
+        largeur = (uint32_t) fmax(1, round((double) largeur_source * hauteur / hauteur_source));
+    if (hauteur == 0)
+        hauteur = (uint32_t) fmax(1, round((double) hauteur_source * largeur / largeur_source));
+    if (largeur > DIMENSION_MAX || hauteur > DIMENSION_MAX || format_image(entete) == FORMAT_PALETTE_8)
+        return NULL;
+
+    entete_bmp resultat = *entete;
+    resultat.bitmap.largeur = largeur;
+    resultat.bitmap.hauteur = hauteur;
+    ajuster_tailles(&resultat);
+
+    banque_filtres horizontale = {0}, verticale = {0};
+    size_t taille_image = (size_t) largeur_source * hauteur_source * sizeof(uint32_t);
+    size_t taille_intermediaire = (size_t) largeur * hauteur_source * sizeof(v4sf);
+    size_t taille_somme = largeur * sizeof(v4sf);
+    size_t taille_redimensionnee = (size_t) largeur * hauteur * sizeof(uint32_t);
+
+    // the scratch buffers live as long as the call: one arena block sized for all of them, freed at once
+    arene_t arene;
+    arene_initialiser(&arene, taille_image + taille_intermediaire + taille_somme + taille_redimensionnee
+                              + 4 * ALIGNEMENT_ARENE);
+    uint32_t *image = arene_allouer(&arene, taille_image);
+    v4sf *intermediaire = arene_allouer(&arene, taille_intermediaire);
+    v4sf *somme = arene_allouer(&arene, taille_somme);
+    uint32_t *redimensionnee = arene_allouer(&arene, taille_redimensionnee);
+    // the padding of the rows is written as is, it must not hold garbage
+    unsigned char *sortie = calloc(taille_pixels(&resultat), 1);
+
+    if (image && intermediaire && somme && redimensionnee && sortie
+        && construire_banque(&horizontale, largeur_source, largeur, mode) == 0
+        && construire_banque(&verticale, hauteur_source, hauteur, mode) == 0
+        && deballer_pixels(entete, pixels, pas, image) == 0)
+    {
+        passe_horizontale(image, largeur_source, hauteur_source, &horizontale, intermediaire);
+        passe_verticale(intermediaire, largeur, &verticale, somme, redimensionnee);
+        emballer_pixels(&resultat, sortie, taille_ligne(&resultat), redimensionnee);
+        *entete = resultat;
+    } else
+    {
+        free(sortie);
+        sortie = NULL;
+    }
+
+    liberer_banque(&horizontale);
+    liberer_banque(&verticale);
+    arene_detruire(&arene);
+    return sortie;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file bmp_redimension.h
+ * @brief Resampling of images to arbitrary dimensions for the BMP modification tool.
+ *
+ * Resampling is separable: a horizontal pass resamples every row to the new width, then a vertical pass
+ * resamples every column to the new height. The weights of each pass only depend on the output position
+ * along its axis, so they are computed once per axis in a filter bank and reused for every row or column.
+ */
+
+#ifndef R305_BMP_REDIMENSION_H
+#define R305_BMP_REDIMENSION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "modif_bmp.h"
+
+/// Option of --modif_bmp resampling the image, followed by WxH[:area|:lanczos]
+#define OPTION_REDIMENSIONNER "--resize"
+
+/// Largest width or height of a resampled image
+#define DIMENSION_MAX 65535
+
+/// Support of the Lanczos kernel, in input pixels when enlarging
+#define LOBES_LANCZOS 3
+
+/// Resampling filters
+typedef enum
+{
+    REDIMENSION_AIRE,    ///< each output pixel is the mean of the input area it covers
+    REDIMENSION_LANCZOS  ///< windowed sinc with LOBES_LANCZOS lobes, sharper but may ring near edges
+} mode_redimension;
+
+/// Weights of the resampling of one axis
+typedef struct
+{
+    uint32_t taille;   ///< number of output positions
+    uint32_t prises;   ///< number of weights stored per output position
+    uint32_t *debut;   ///< first input position contributing to each output position
+    uint32_t *nombre;  ///< number of input positions contributing to each output position
+    float *poids;      ///< `prises` weights per output position, summing to 1
+} banque_filtres;
+
+/**
+ * @brief Reads the argument of OPTION_REDIMENSIONNER.
+ *
+ * One of the dimensions may be 0, it is then computed from the other one to keep the aspect ratio.
+ *
+ * @param argument The argument, of the form WxH, WxH:area or WxH:lanczos.
+ * @param largeur Receives the width.
+ * @param hauteur Receives the height.
+ * @param mode Receives the filter, REDIMENSION_AIRE by default.
+ * @return 0 on success, -1 if the argument is malformed.
+ */
+int lire_dimensions(const char *argument, uint32_t *largeur, uint32_t *hauteur, mode_redimension *mode);
+
+/**
+ * @brief Computes the weights resampling an axis of `source` pixels to `destination` pixels.
+ *
+ * @param banque The filter bank to fill, to be freed with liberer_banque.
+ * @param source The number of input positions.
+ * @param destination The number of output positions.
+ * @param mode The filter.
+ * @return 0 on success, -1 if memory allocation failed.
+ */
+int construire_banque(banque_filtres *banque, uint32_t source, uint32_t destination, mode_redimension mode);
+
+/**
+ * @brief Frees the arrays of a filter bank.
+ *
+ * @param banque The filter bank.
+ */
+void liberer_banque(banque_filtres *banque);
+
+/**
+ * @brief Resamples a view of an image to new dimensions.
+ *
+ * @param entete Pointer to the header describing the view, updated with the new dimensions and sizes.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows of the view.
+ * @param largeur The new width. If 0, it is computed from the height to keep the aspect ratio.
+ * @param hauteur The new height. If 0, it is computed from the width to keep the aspect ratio.
+ * @param mode The filter.
+ * @return The allocated pixels of the resampled image, rows padded as in a file, or NULL on error
+ *         (paletted image, invalid dimensions or allocation failure). The header is unchanged on error.
+ */
+unsigned char *redimensionner(entete_bmp *entete, const unsigned char *pixels, size_t pas, uint32_t largeur,
+                              uint32_t hauteur, mode_redimension mode);
+
+#endif //R305_BMP_REDIMENSION_H
@@ -0,0 +1,55 @@
+/**
+ * @file bmp_simd.h
+ * @brief Vector types shared by the BMP filters that accumulate several pixels.
+ *
+ * The filters work on pixels widened to four 32-bit lanes (blue, green, red, alpha) so that every
+ * channel of a pixel is updated by a single vector operation. The types rely on the vector extension
+ * of GCC and Clang, which maps them onto SSE2 or NEON registers without any platform-specific code.
+ */
+
+#ifndef R305_BMP_SIMD_H
+#define R305_BMP_SIMD_H
+
+#include <stdint.h>
+#include <string.h>
+
+/// Four 32-bit integer lanes, one per channel
+typedef int32_t v4si __attribute__((vector_size(16)));
+
+/// Four single-precision lanes, one per channel
+typedef float v4sf __attribute__((vector_size(16)));
+
+/// The four bytes of a pixel of the working buffers
+typedef uint8_t v4qu __attribute__((vector_size(4)));
+
+/**
+ * @brief Widens a 4-byte pixel to four integer lanes.
+ */
+static inline v4si charger_pixel(const uint32_t *pixel)
+{
+    v4qu octets;
+    memcpy(&octets, pixel, sizeof(octets));
+    return __builtin_convertvector(octets, v4si);
+}
+
+/**
+ * @brief Narrows four integer lanes, already in [0, 255], to a 4-byte pixel.
+ */
+static inline void ranger_pixel(uint32_t *pixel, v4si valeur)
+{
+    v4qu octets = __builtin_convertvector(valeur, v4qu);
+    memcpy(pixel, &octets, sizeof(octets));
+}
+
+/**
+ * @brief Clamps four integer lanes to [0, 255].
+ */
+static inline v4si saturer(v4si valeur)
+{
+    v4si negatif = valeur < 0;
+    v4si depasse = valeur > 255;
+    valeur &= ~negatif;
+    return (valeur & ~depasse) | (depasse & 255);
+}
+
+#endif //R305_BMP_SIMD_H
@@ -0,0 +1,271 @@
+/**
+ * @file bmp_statistiques.c
+ * @brief Histograms, statistics and automatic levels of images for the BMP modification tool.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "bmp_statistiques.h"
+
+/// Luma of a pixel (ITU-R BT.601 weights in 8-bit fixed point, they sum to 256)
+#define LUMA(bleu, vert, rouge) (((bleu) * 29 + (vert) * 150 + (rouge) * 77 + 128) >> 8)
+
+/**
+ * @brief Body of a counting thread.
+ *
+ * Rows are unpacked one at a time to 4-byte pixels, so that every format is counted by the same loop
+ * while the padding at the end of the rows is skipped. The indices of paletted images are counted in
+ * the first histogram, they are translated to colours once the bands are merged.
+ *
+ * @param argument Pointer to the tranche_statistiques of the thread.
+ * @return NULL
+ */
+static void *compter_tranche(void *argument)
+{
+    tranche_statistiques *tranche = argument;
+    uint32_t largeur = tranche->entete->bitmap.largeur;
+
+    if (format_image(tranche->entete) == FORMAT_PALETTE_8)
+    {
+        for (uint32_t line = 0; line < tranche->lignes; line++)
+        {
+            const unsigned char *indices = tranche->pixels + line * tranche->pas;
+            for (uint32_t col = 0; col < largeur; col++)
+                tranche->histogrammes[0][indices[col]]++;
+        }
+        return NULL;
+    }
+
+    // a view of a single row, handed to deballer_pixels
+    entete_bmp ligne = *tranche->entete;
+    ligne.bitmap.hauteur = 1;
+
+    uint32_t *pixels = malloc(largeur * sizeof(uint32_t));
+    if (!pixels)
+    {
+        tranche->erreur = 1;
+        return NULL;
+    }
+
+    for (uint32_t line = 0; line < tranche->lignes; line++)
+    {
+        deballer_pixels(&ligne, tranche->pixels + line * tranche->pas, tranche->pas, pixels);
+
+        const unsigned char *x = (const unsigned char *) pixels;
+        for (uint32_t col = 0; col < largeur; col++, x += 4)
+        {
+            tranche->histogrammes[0][x[0]]++;
+            tranche->histogrammes[1][x[1]]++;
+            tranche->histogrammes[2][x[2]]++;
+            tranche->histogrammes[CANAL_LUMA][LUMA(x[0], x[1], x[2])]++;
+        }
+    }
+
+    free(pixels);
+    return NULL;
+}
+
+/**
+ * @brief Computes the histograms, extrema and means of the channels and of the luma of a view of an image.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ * @param statistiques Receives the statistics.
+ * @return 0 on success, -1 on error.
+ */
+int calculer_statistiques(entete_bmp *entete, const unsigned char *pixels, size_t pas,
+                          statistiques_bmp *statistiques)
+{
+    uint32_t hauteur = entete->bitmap.hauteur;
+    long nb_threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (nb_threads > (long) (hauteur / LIGNES_PAR_THREAD_MIN))
+        nb_threads = hauteur / LIGNES_PAR_THREAD_MIN;
+    if (nb_threads > THREADS_STATISTIQUES_MAX)
+        nb_threads = THREADS_STATISTIQUES_MAX;
+    if (nb_threads < 1)
+        nb_threads = 1;
+
+    tranche_statistiques *tranches = calloc(nb_threads, sizeof(tranche_statistiques));
+    pthread_t threads[nb_threads];
+    if (!tranches)
+        return -1;
+
+    // the first band, counted by the calling thread, also takes the rows left by the division
+    uint32_t premiere = 0;
+    for (long i = 0; i < nb_threads; i++)
+    {
+        tranches[i].entete = entete;
+        tranches[i].pas = pas;
+        tranches[i].lignes = hauteur / nb_threads + (i == 0 ? hauteur % nb_threads : 0);
+        tranches[i].pixels = pixels + (size_t) premiere * pas;
+        premiere += tranches[i].lignes;
+    }
+
+    long lances = 1;
+    for (; lances < nb_threads; lances++)
+    {
+        if (pthread_create(&threads[lances], NULL, compter_tranche, &tranches[lances]) != 0)
+            break;
+    }
+    compter_tranche(&tranches[0]);
+    for (long i = lances; i < nb_threads; i++)
+        compter_tranche(&tranches[i]);  // the bands whose thread could not be created
+    for (long i = 1; i < lances; i++)
+        pthread_join(threads[i], NULL);
+
+    memset(statistiques, 0, sizeof(*statistiques));
+    int erreur = 0;
+    for (long i = 0; i < nb_threads; i++)
+    {
+        erreur |= tranches[i].erreur;
+        for (int canal = 0; canal < NOMBRE_HISTOGRAMMES; canal++)
+        {
+            for (int valeur = 0; valeur < 256; valeur++)
+                statistiques->histogrammes[canal][valeur] += tranches[i].histogrammes[canal][valeur];
+        }
+    }
+    free(tranches);
+    if (erreur)
+        return -1;
+
+    if (format_image(entete) == FORMAT_PALETTE_8)
+    {
+        uint32_t couleurs;
+        const unsigned char *palette = palette_image(entete, &couleurs);
+        uint64_t indices[256];
+
+        memcpy(indices, statistiques->histogrammes[0], sizeof(indices));
+        memset(statistiques->histogrammes[0], 0, sizeof(indices));
+        for (uint32_t indice = 0; indice < 256; indice++)
+        {
+            // an index outside of the palette is counted as black
+            const unsigned char noir[4] = {0};
+            const unsigned char *x = indice < couleurs ? palette + indice * 4 : noir;
+            statistiques->histogrammes[0][x[0]] += indices[indice];
+            statistiques->histogrammes[1][x[1]] += indices[indice];
+            statistiques->histogrammes[2][x[2]] += indices[indice];
+            statistiques->histogrammes[CANAL_LUMA][LUMA(x[0], x[1], x[2])] += indices[indice];
+        }
+    }
+
+    // the extrema and the means are read from the histograms instead of being tracked for every pixel
+    statistiques->pixels = (uint64_t) entete->bitmap.largeur * hauteur;
+    for (int canal = 0; canal < NOMBRE_HISTOGRAMMES; canal++)
+    {
+        uint64_t somme = 0;
+        int minimum = -1, maximum = 0;
+
+        for (int valeur = 0; valeur < 256; valeur++)
+        {
+            uint64_t nombre = statistiques->histogrammes[canal][valeur];
+            if (nombre == 0)
+                continue;
+            if (minimum == -1)
+                minimum = valeur;
+            maximum = valeur;
+            somme += nombre * valeur;
+        }
+
+        statistiques->minimum[canal] = minimum == -1 ? 0 : minimum;
+        statistiques->maximum[canal] = maximum;
+        statistiques->moyenne[canal] = statistiques->pixels ? (double) somme / statistiques->pixels : 0;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Prints statistics: a summary per channel followed by the histograms.
+ *
+ * The whole report is printed under the lock of stdout, so that the reports of the images of a batch
+ * are not interleaved.
+ *
+ * @param nom Name of the image, printed as a title.
+ * @param statistiques The statistics.
+ */
+void afficher_statistiques(const char *nom, const statistiques_bmp *statistiques)
+{
+    const char *canaux[NOMBRE_HISTOGRAMMES] = {"blue", "green", "red", "luma"};
+
+    flockfile(stdout);
+    printf("Statistics of %s (%llu pixels)\n", nom, (unsigned long long) statistiques->pixels);
+    printf("%-8s%6s%6s%10s\n", "channel", "min", "max", "mean");
+    for (int canal = 0; canal < NOMBRE_HISTOGRAMMES; canal++)
+    {
+        printf("%-8s%6d%6d%10.2f\n", canaux[canal], statistiques->minimum[canal], statistiques->maximum[canal],
+               statistiques->moyenne[canal]);
+    }
+
+    printf("%-8s%12s%12s%12s%12s\n", "value", canaux[0], canaux[1], canaux[2], canaux[3]);
+    for (int valeur = 0; valeur < 256; valeur++)
+    {
+        printf("%-8d", valeur);
+        for (int canal = 0; canal < NOMBRE_HISTOGRAMMES; canal++)
+            printf("%12llu", (unsigned long long) statistiques->histogrammes[canal][valeur]);
+        printf("\n");
+    }
+    funlockfile(stdout);
+}
+
+/**
+ * @brief Computes the lookup tables stretching each channel to the full range.
+ *
+ * The darkest and the brightest ECRETAGE_NIVEAUX of the pixels of each channel are saturated, so that
+ * a few outliers do not prevent the stretch. The values in between are mapped linearly onto [0, 255].
+ * A channel holding a single level is left unchanged.
+ *
+ * @param statistiques Statistics of the image.
+ * @param tables Receives the lookup tables of the blue, green and red channels.
+ */
+void calculer_niveaux(const statistiques_bmp *statistiques, tables_canaux *tables)
+{
+    uint64_t ecretes = (uint64_t) (statistiques->pixels * ECRETAGE_NIVEAUX);
+
+    for (int canal = 0; canal < 3; canal++)
+    {
+        const uint64_t *histogramme = statistiques->histogrammes[canal];
+        int bas = 0, haut = 255;
+        uint64_t cumul = histogramme[0];
+
+        while (bas < 255 && cumul <= ecretes)
+            cumul += histogramme[++bas];
+        for (cumul = histogramme[255]; haut > 0 && cumul <= ecretes;)
+            cumul += histogramme[--haut];
+
+        for (int valeur = 0; valeur < 256; valeur++)
+        {
+            int niveau = valeur;
+            if (haut > bas)
+            {
+                niveau = ((valeur - bas) * 255 + (haut - bas) / 2) / (haut - bas);
+                niveau = niveau < 0 ? 0 : niveau > 255 ? 255 : niveau;
+            }
+            tables->canaux[canal][valeur] = (unsigned char) niveau;
+        }
+    }
+}
+
+/**
+ * @brief Stretches the levels of each channel of a view of an image to the full range.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ * @return 0 on success, -1 on error.
+ */
+int niveaux_automatiques(entete_bmp *entete, unsigned char *pixels, size_t pas)
+{
+    statistiques_bmp statistiques;
+    tables_canaux tables;
+
+    if (calculer_statistiques(entete, pixels, pas, &statistiques) == -1)
+        return -1;
+
+    calculer_niveaux(&statistiques, &tables);
+    appliquer_tables(entete, pixels, pas, &tables);
+    return 0;
+}
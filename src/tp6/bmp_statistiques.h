@@ -0,0 +1,98 @@
+/**
+ * @file bmp_statistiques.h
+ * @brief Histograms, statistics and automatic levels of images for the BMP modification tool.
+ *
+ * The histograms of an image are computed in a single pass over its rows, split into bands processed by
+ * several threads. Each thread counts into histograms of its own, merged once every band is done, so that
+ * the threads never write to shared counters.
+ */
+
+#ifndef R305_BMP_STATISTIQUES_H
+#define R305_BMP_STATISTIQUES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "modif_bmp.h"
+
+/// Option of --modif_bmp printing the statistics of the image
+#define OPTION_STATISTIQUES "--stats"
+
+/// Option of --modif_bmp stretching the levels of each channel to the full range
+#define OPTION_NIVEAUX "--autolevels"
+
+/// Index of the luma histogram, after the blue, green and red ones
+#define CANAL_LUMA 3
+
+/// Number of histograms: blue, green, red and luma
+#define NOMBRE_HISTOGRAMMES 4
+
+/// Fewest rows given to a thread, smaller images are counted by fewer threads
+#define LIGNES_PAR_THREAD_MIN 64
+
+/// Largest number of threads counting an image
+#define THREADS_STATISTIQUES_MAX 64
+
+/// Fraction of the pixels of each channel saturated to black and to white by the automatic levels
+#define ECRETAGE_NIVEAUX 0.001
+
+/// Statistics of an image
+typedef struct
+{
+    uint64_t histogrammes[NOMBRE_HISTOGRAMMES][256];  ///< number of pixels of each value, per channel
+    uint64_t pixels;                                  ///< number of pixels counted
+    unsigned char minimum[NOMBRE_HISTOGRAMMES];       ///< smallest value of each channel
+    unsigned char maximum[NOMBRE_HISTOGRAMMES];       ///< largest value of each channel
+    double moyenne[NOMBRE_HISTOGRAMMES];              ///< mean value of each channel
+} statistiques_bmp;
+
+/// A band of rows counted by one thread, with its private histograms
+typedef struct
+{
+    const entete_bmp *entete;                         ///< header of the whole view
+    const unsigned char *pixels;                      ///< first row of the band
+    size_t pas;                                       ///< number of bytes between two consecutive rows
+    uint32_t lignes;                                  ///< number of rows of the band
+    uint64_t histogrammes[NOMBRE_HISTOGRAMMES][256];  ///< counts of the band
+    int erreur;                                       ///< set if the band could not be counted
+} tranche_statistiques;
+
+/**
+ * @brief Computes the histograms, extrema and means of the channels and of the luma of a view of an image.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ * @param statistiques Receives the statistics.
+ * @return 0 on success, -1 on error.
+ */
+int calculer_statistiques(entete_bmp *entete, const unsigned char *pixels, size_t pas,
+                          statistiques_bmp *statistiques);
+
+/**
+ * @brief Prints statistics: a summary per channel followed by the histograms.
+ *
+ * @param nom Name of the image, printed as a title.
+ * @param statistiques The statistics.
+ */
+void afficher_statistiques(const char *nom, const statistiques_bmp *statistiques);
+
+/**
+ * @brief Computes the lookup tables stretching each channel to the full range.
+ *
+ * @param statistiques Statistics of the image.
+ * @param tables Receives the lookup tables of the blue, green and red channels.
+ */
+void calculer_niveaux(const statistiques_bmp *statistiques, tables_canaux *tables);
+
+/**
+ * @brief Stretches the levels of each channel of a view of an image to the full range.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ * @return 0 on success, -1 on error.
+ */
+int niveaux_automatiques(entete_bmp *entete, unsigned char *pixels, size_t pas);
+
+#endif //R305_BMP_STATISTIQUES_H
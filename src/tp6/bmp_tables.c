@@ -0,0 +1,223 @@
+/**
+ * @file bmp_tables.c
+ * @brief Point operations of the BMP modification tool compiled into per-channel lookup tables.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "bmp_tables.h"
+
+/**
+ * @brief Tells whether an option is a point operation and how many arguments follow it.
+ *
+ * @param option The option.
+ * @return The number of arguments of the operation, or -1 if the option is not a point operation.
+ */
+int arguments_operation(const char *option)
+{
+    if (strcmp(option, "-r") == 0 || strcmp(option, "-n") == 0 || strcmp(option, "-b") == 0)
+        return 0;
+    if (strcmp(option, OPTION_GAMMA) == 0 || strcmp(option, OPTION_LUMINOSITE) == 0
+        || strcmp(option, OPTION_CONTRASTE) == 0 || strcmp(option, OPTION_SEUIL) == 0
+        || strcmp(option, OPTION_MASQUE) == 0)
+        return 1;
+    return -1;
+}
+
+/**
+ * @brief Fills tables with the identity.
+ *
+ * @param tables The tables.
+ */
+void tables_identite(tables_canaux *tables)
+{
+    for (int canal = 0; canal < 3; canal++)
+    {
+        for (int valeur = 0; valeur < 256; valeur++)
+            tables->canaux[canal][valeur] = (unsigned char) valeur;
+    }
+}
+
+/**
+ * @brief Reads a number that must make up the whole argument.
+ *
+ * @return 0 on success, -1 if the argument is missing or is not a number.
+ */
+static int lire_nombre(const char *argument, double *nombre)
+{
+    char *fin;
+
+    if (argument == NULL || *argument == '\0')
+        return -1;
+    *nombre = strtod(argument, &fin);
+    return *fin == '\0' && isfinite(*nombre) ? 0 : -1;
+}
+
+/**
+ * @brief Rounds a level and clamps it to [0, 255].
+ */
+static unsigned char saturer_niveau(double niveau)
+{
+    return niveau <= 0 ? 0 : niveau >= 255 ? 255 : (unsigned char) (niveau + 0.5);
+}
+
+/**
+ * @brief Composes a point operation after the operations already in a set of tables.
+ *
+ * The table of the operation alone is computed first, then every entry of the tables is replaced
+ * by its image through the operation.
+ *
+ * @param tables The tables, updated so that they apply the operation to their former result.
+ * @param option The option of the operation, any operation but black and white.
+ * @param argument The argument of the operation, if it takes one.
+ * @return 0 on success, -1 if the option is not a table operation or the argument is malformed.
+ */
+int composer_operation(tables_canaux *tables, const char *option, const char *argument)
+{
+    tables_canaux operation;
+    double nombre = 0;
+
+    if (arguments_operation(option) == 1 && strcmp(option, OPTION_MASQUE) != 0
+        && lire_nombre(argument, &nombre) == -1)
+        return -1;
+
+    if (strcmp(option, "-r") == 0 || strcmp(option, OPTION_MASQUE) == 0)
+    {
+        // -r is the mask keeping the red channel only
+        const char *gardes = strcmp(option, "-r") == 0 ? "r" : argument;
+        const char noms[3] = {'b', 'g', 'r'};
+
+        if (gardes == NULL || *gardes == '\0' || strspn(gardes, "rgb") != strlen(gardes))
+            return -1;
+        tables_identite(&operation);
+        for (int canal = 0; canal < 3; canal++)
+        {
+            if (!strchr(gardes, noms[canal]))
+                memset(operation.canaux[canal], 0, 256);
+        }
+    } else
+    {
+        for (int valeur = 0; valeur < 256; valeur++)
+        {
+            unsigned char niveau;
+
+            if (strcmp(option, "-n") == 0)
+                niveau = (unsigned char) ~valeur;
+            else if (strcmp(option, OPTION_GAMMA) == 0 && nombre > 0)
+                niveau = saturer_niveau(255 * pow(valeur / 255.0, 1 / nombre));
+            else if (strcmp(option, OPTION_LUMINOSITE) == 0 && fabs(nombre) <= 255)
+                niveau = saturer_niveau(valeur + nombre);
+            else if (strcmp(option, OPTION_CONTRASTE) == 0 && nombre >= 0)
+                niveau = saturer_niveau((valeur - 128) * nombre + 128);
+            else if (strcmp(option, OPTION_SEUIL) == 0 && nombre >= 0 && nombre <= 256)
+                niveau = valeur >= nombre ? 255 : 0;
+            else
+                return -1;
+
+            operation.canaux[0][valeur] = operation.canaux[1][valeur] = operation.canaux[2][valeur] = niveau;
+        }
+    }
+
+    for (int canal = 0; canal < 3; canal++)
+    {
+        for (int valeur = 0; valeur < 256; valeur++)
+            tables->canaux[canal][valeur] = operation.canaux[canal][tables->canaux[canal][valeur]];
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Adds a step at the end of a chain.
+ *
+ * @return The new step, or NULL if memory allocation failed.
+ */
+static etape_ponctuelle *ajouter_etape(chaine_ponctuelle *chaine, int noir_et_blanc)
+{
+    if (chaine->nombre == chaine->capacite)
+    {
+        int capacite = chaine->capacite ? chaine->capacite * 2 : 4;
+        etape_ponctuelle *etapes = realloc(chaine->etapes, capacite * sizeof(etape_ponctuelle));
+        if (!etapes)
+            return NULL;
+        chaine->etapes = etapes;
+        chaine->capacite = capacite;
+    }
+
+    etape_ponctuelle *etape = &chaine->etapes[chaine->nombre++];
+    etape->noir_et_blanc = noir_et_blanc;
+    tables_identite(&etape->tables);
+    return etape;
+}
+
+/**
+ * @brief Appends the consecutive point operations at the start of an option list to a chain.
+ *
+ * An operation following a table step of the chain is composed into it, so that a run of operations
+ * without black and white between them always ends up as a single step.
+ *
+ * @param chaine The chain, initialised to {0} before its first use.
+ * @param options The options.
+ * @param nb_options The number of options.
+ * @return The number of options consumed, arguments included, or -1 on error (malformed argument or
+ *         allocation failure).
+ */
+int compiler_chaine(chaine_ponctuelle *chaine, char **options, int nb_options)
+{
+    int i = 0;
+
+    while (i < nb_options)
+    {
+        int arguments = arguments_operation(options[i]);
+        if (arguments == -1)
+            break;
+        if (i + arguments >= nb_options)
+            return -1;
+
+        int noir_et_blanc = strcmp(options[i], "-b") == 0;
+        etape_ponctuelle *etape = chaine->nombre > 0 ? &chaine->etapes[chaine->nombre - 1] : NULL;
+        if (noir_et_blanc || !etape || etape->noir_et_blanc)
+            etape = ajouter_etape(chaine, noir_et_blanc);
+        if (!etape)
+            return -1;
+
+        if (!noir_et_blanc && composer_operation(&etape->tables, options[i], arguments ? options[i + 1] : NULL) == -1)
+            return -1;
+        i += 1 + arguments;
+    }
+
+    return i;
+}
+
+/**
+ * @brief Applies a chain of point operations to a view of an image.
+ *
+ * @param chaine The chain.
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ */
+void executer_chaine(const chaine_ponctuelle *chaine, entete_bmp *entete, unsigned char *pixels, size_t pas)
+{
+    for (int i = 0; i < chaine->nombre; i++)
+    {
+        if (chaine->etapes[i].noir_et_blanc)
+            appliquer_filtre_vue("-b", entete, pixels, pas);
+        else
+            appliquer_tables(entete, pixels, pas, &chaine->etapes[i].tables);
+    }
+}
+
+/**
+ * @brief Frees the steps of a chain and empties it.
+ *
+ * @param chaine The chain.
+ */
+void liberer_chaine(chaine_ponctuelle *chaine)
+{
+    free(chaine->etapes);
+    chaine->etapes = NULL;
+    chaine->nombre = 0;
+    chaine->capacite = 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file bmp_tables.h
+ * @brief Point operations of the BMP modification tool compiled into per-channel lookup tables.
+ *
+ * An operation that computes each channel of a pixel from that channel alone is a function from 256 values
+ * to 256 values, stored as a table. A chain of such operations is the composition of their tables, computed
+ * once when the options are read, so that applying any number of them costs a single lookup per channel.
+ * Black and white (-b) mixes the channels: it cannot be a table and splits the chain into several steps.
+ */
+
+#ifndef R305_BMP_TABLES_H
+#define R305_BMP_TABLES_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "modif_bmp.h"
+
+/// Option of --modif_bmp applying a gamma correction, followed by the gamma (greater than 1 brightens)
+#define OPTION_GAMMA "--gamma"
+
+/// Option of --modif_bmp adding a value to every channel, followed by the value, between -255 and 255
+#define OPTION_LUMINOSITE "--brightness"
+
+/// Option of --modif_bmp scaling the distance of every channel to 128, followed by the factor
+#define OPTION_CONTRASTE "--contrast"
+
+/// Option of --modif_bmp setting every channel to 0 below the threshold and to 255 from it, followed by the threshold
+#define OPTION_SEUIL "--threshold"
+
+/// Option of --modif_bmp keeping some channels and setting the others to 0, followed by the kept channels among "rgb"
+#define OPTION_MASQUE "--mask"
+
+/// A step of a chain of point operations
+typedef struct
+{
+    int noir_et_blanc;     ///< 1 if the step is the black and white filter, 0 if it applies the tables
+    tables_canaux tables;  ///< the composed tables of the step
+} etape_ponctuelle;
+
+/// A chain of point operations, consecutive tables being composed into a single step
+typedef struct
+{
+    int nombre;                ///< number of steps
+    int capacite;              ///< allocated number of steps
+    etape_ponctuelle *etapes;  ///< the steps, in the order they apply
+} chaine_ponctuelle;
+
+/**
+ * @brief Tells whether an option is a point operation and how many arguments follow it.
+ *
+ * @param option The option.
+ * @return The number of arguments of the operation, or -1 if the option is not a point operation.
+ */
+int arguments_operation(const char *option);
+
+/**
+ * @brief Fills tables with the identity.
+ *
+ * @param tables The tables.
+ */
+void tables_identite(tables_canaux *tables);
+
+/**
+ * @brief Composes a point operation after the operations already in a set of tables.
+ *
+ * @param tables The tables, updated so that they apply the operation to their former result.
+ * @param option The option of the operation, any operation but black and white.
+ * @param argument The argument of the operation, if it takes one.
+ * @return 0 on success, -1 if the option is not a table operation or the argument is malformed.
+ */
+int composer_operation(tables_canaux *tables, const char *option, const char *argument);
+
+/**
+ * @brief Appends the consecutive point operations at the start of an option list to a chain.
+ *
+ * @param chaine The chain, initialised to {0} before its first use.
+ * @param options The options.
+ * @param nb_options The number of options.
+ * @return The number of options consumed, arguments included, or -1 on error (malformed argument or
+ *         allocation failure).
+ */
+int compiler_chaine(chaine_ponctuelle *chaine, char **options, int nb_options);
+
+/**
+ * @brief Applies a chain of point operations to a view of an image.
+ *
+ * @param chaine The chain.
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ */
+void executer_chaine(const chaine_ponctuelle *chaine, entete_bmp *entete, unsigned char *pixels, size_t pas);
+
+/**
+ * @brief Frees the steps of a chain and empties it.
+ *
+ * @param chaine The chain.
+ */
+void liberer_chaine(chaine_ponctuelle *chaine);
+
+#endif //R305_BMP_TABLES_H
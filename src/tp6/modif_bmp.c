@@ -6,7 +6,18 @@
 #include <unistd.h>
 #include <string.h>
 #include <stdio.h>
+#include <inttypes.h>
+#include <sys/uio.h>
 #include "modif_bmp.h"
+#include "bmp_noyaux.h"
+#include "bmp_flux.h"
+#include "bmp_lot.h"
+#include "bmp_convolution.h"
+#include "bmp_redimension.h"
+#include "bmp_statistiques.h"
+#include "bmp_tables.h"
+#include "bmp_geometrie.h"
+#include "bmp_banc.h"
 
 /**
  * @brief Reads two bytes from a file descriptor and stores them in a uint16_t variable.
@@ -102,6 +113,18 @@ int lire_entete(int fd, entete_bmp *entete)
         return -1;  // return -1 if any reading operation fails
     }
 
+    // keep the end of larger headers, the bit masks and the palette to write them back unchanged
+    entete->taille_extension = 0;
+    if (entete->fichier.offset_donnees > TAILLE_ENTETES)
+    {
+        uint32_t taille = entete->fichier.offset_donnees - TAILLE_ENTETES;
+        if (taille > TAILLE_EXTENSION_MAX)
+            taille = TAILLE_EXTENSION_MAX;
+        if (lire_exactement(fd, entete->extension, taille) == -1)
+            return -1;
+        entete->taille_extension = taille;
+    }
+
     return 0;
 }
 
@@ -185,44 +208,220 @@ int ecrire_entete(int fd, entete_bmp *entete)
         return -1; // return -1 if any writing operation fails
     }
 
+    if (ecrire_exactement(fd, entete->extension, entete->taille_extension) == -1)
+    {
+        return -1;
+    }
+
     return 0;
 }
 
 /**
- * @brief Verifies if the image depth is 24 bits.
+ * @brief Reads one of the red, green and blue bit masks that follow the 40-byte bitmap header.
+ *
+ * @param entete Pointer to the BMP header structure.
+ * @param canal 0 for red, 1 for green, 2 for blue.
+ * @return The mask, 0 if the header is too short to hold it.
+ */
+static uint32_t masque_canal(const entete_bmp *entete, int canal)
+{
+    uint32_t masque = 0;
+    if (entete->taille_extension >= (canal + 1) * sizeof(masque))
+        memcpy(&masque, entete->extension + canal * sizeof(masque), sizeof(masque));
+    return masque;
+}
+
+/**
+ * @brief Determines the pixel format of a BMP image from its depth, compression and bit masks.
+ *
+ * @param entete Pointer to the BMP header structure.
+ * @return The pixel format, FORMAT_INCONNU if the tool does not support it.
+ */
+format_pixels format_image(const entete_bmp *entete)
+{
+    uint32_t compression = entete->bitmap.compression;
+    uint32_t rouge = masque_canal(entete, 0), vert = masque_canal(entete, 1), bleu = masque_canal(entete, 2);
+
+    switch (entete->bitmap.profondeur)
+    {
+        case 8:
+        {
+            uint32_t nombre;
+            unsigned char *palette = palette_image((entete_bmp *) entete, &nombre);
+            // the whole palette must have been kept by lire_entete
+            if (compression == COMPRESSION_AUCUNE
+                && palette + (size_t) nombre * 4 <= entete->extension + entete->taille_extension)
+                return FORMAT_PALETTE_8;
+            return FORMAT_INCONNU;
+        }
+        case 16:
+            if (compression == COMPRESSION_AUCUNE
+                || (compression == COMPRESSION_CHAMPS_BITS && rouge == 0x7C00 && vert == 0x03E0 && bleu == 0x001F))
+                return FORMAT_RGB_555;
+            if (compression == COMPRESSION_CHAMPS_BITS && rouge == 0xF800 && vert == 0x07E0 && bleu == 0x001F)
+                return FORMAT_RGB_565;
+            return FORMAT_INCONNU;
+        case 24:
+            return compression == COMPRESSION_AUCUNE ? FORMAT_BGR_24 : FORMAT_INCONNU;
+        case 32:
+            if (compression == COMPRESSION_AUCUNE
+                || (compression == COMPRESSION_CHAMPS_BITS && rouge == 0xFF0000 && vert == 0xFF00 && bleu == 0xFF))
+                return FORMAT_BGRA_32;
+            return FORMAT_INCONNU;
+        default:
+            return FORMAT_INCONNU;
+    }
+}
+
+/**
+ * @brief Returns the number of bytes of one pixel.
+ *
+ * @param entete Pointer to the BMP header structure.
+ * @return The depth of the image divided by 8.
+ */
+uint32_t octets_par_pixel(const entete_bmp *entete)
+{
+    return entete->bitmap.profondeur / 8;
+}
+
+/**
+ * @brief Locates the palette of a paletted image in the header extension.
  *
- * This function takes a pointer to an entete_bmp structure as input and
- * checks if the depth of the image, stored in its bitmap field, is equal to
- * 24 bits. If the depth is 24 bits, it returns 1; otherwise, it returns 0.
+ * The palette follows the bitmap header, whose size is given by taille_entete. A palette size of 0 means
+ * the largest palette for the depth.
+ *
+ * @param entete Pointer to the BMP header structure.
+ * @param nombre Receives the number of colors of the palette.
+ * @return Pointer to the first entry of the palette.
+ */
+unsigned char *palette_image(entete_bmp *entete, uint32_t *nombre)
+{
+    uint32_t taille_minimale = TAILLE_ENTETES - TAILLE_ENTETE_FICHIER;
+    uint32_t debut = entete->bitmap.taille_entete > taille_minimale ? entete->bitmap.taille_entete - taille_minimale : 0;
+
+    *nombre = entete->bitmap.taille_palette;
+    if (*nombre == 0 || *nombre > 256)
+        *nombre = 256;
+
+    if (debut > TAILLE_EXTENSION_MAX)
+        debut = TAILLE_EXTENSION_MAX;
+    return entete->extension + debut;
+}
+
+/**
+ * @brief Verifies if the pixel format of the image is supported and its declared pixel data covers every row.
+ *
+ * This function takes a pointer to an entete_bmp structure as input and checks that the image has at least
+ * one row and one column, that its pixels are 8-bit paletted, 16-bit, 24-bit or 32-bit, and that a non-zero
+ * `taille_donnees_image` is not smaller than the rows every filter walks. If so, it returns 1; otherwise,
+ * it returns 0.
  *
  * @param entete Pointer to the entete_bmp structure to be verified.
- * @return 1 if the depth is 24 bits, 0 otherwise.
+ * @return 1 if the format is supported, 0 otherwise.
  */
 int verifier_entete(const entete_bmp *entete)
 {
-    // verify the image depth is 24 bits
-    if (entete->bitmap.profondeur == 24)
+    if (entete->bitmap.largeur == 0 || entete->bitmap.hauteur == 0 || format_image(entete) == FORMAT_INCONNU)
+        return 0;
+    return entete->bitmap.taille_donnees_image == 0 || entete->bitmap.taille_donnees_image >= taille_pixels(entete);
+}
+
+/**
+ * @brief Computes the size in bytes of one row of pixels, padding included.
+ *
+ * @param entete Pointer to the BMP header structure.
+ * @return The number of bytes occupied by one row in the file.
+ */
+size_t taille_ligne(const entete_bmp *entete)
+{
+    size_t bits = (size_t) entete->bitmap.largeur * entete->bitmap.profondeur;
+    return (bits + 31) / 32 * 4; // line padding to 4 bytes
+}
+
+/**
+ * @brief Computes the size in bytes of the pixel data of a BMP image.
+ *
+ * The size always comes from the width, height and padding, the rows every filter walks: `taille_donnees_image`
+ * may be 0, and a file could declare less, which verifier_entete rejects.
+ *
+ * @param entete Pointer to the BMP header structure.
+ * @return The number of bytes of pixel data.
+ */
+uint64_t taille_pixels(const entete_bmp *entete)
+{
+    return (uint64_t) taille_ligne(entete) * entete->bitmap.hauteur;
+}
+
+/**
+ * @brief Reads exactly `taille` bytes from a file descriptor.
+ *
+ * @param fd The file descriptor to read from.
+ * @param tampon The buffer receiving the data.
+ * @param taille The number of bytes to read.
+ * @return 0 on success, -1 on error or premature end of file.
+ */
+int lire_exactement(int fd, void *tampon, size_t taille)
+{
+    unsigned char *curseur = tampon;
+
+    while (taille > 0)
     {
-        return 1;   // return 1 if the depth is 24 bits
-    } else
+        ssize_t result = read(fd, curseur, taille);
+        if (result <= 0)
+        {
+            return -1;  // error or end of file before the end of the data
+        }
+        curseur += result;
+        taille -= result;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Writes exactly `taille` bytes to a file descriptor.
+ *
+ * @param fd The file descriptor to write to.
+ * @param tampon The data to write.
+ * @param taille The number of bytes to write.
+ * @return 0 on success, -1 on error.
+ */
+int ecrire_exactement(int fd, const void *tampon, size_t taille)
+{
+    const unsigned char *curseur = tampon;
+
+    while (taille > 0)
     {
-        return 0;   // return 0 otherwise
+        ssize_t result = write(fd, curseur, taille);
+        if (result < 0)
+        {
+            return -1;  // return -1 if failed to write
+        }
+        curseur += result;
+        taille -= result;
     }
+
+    return 0;
 }
 
 /**
  * @brief Allocates memory for storing pixel data.
  *
  * This function allocates a memory block to store pixel data for a BMP image. The size of the memory block is
- * calculated using the size of the image data in the given bitmap header.
+ * calculated from the dimensions of the image, see taille_pixels.
  *
  * @param entete The header of the BMP image.
  * @return A pointer to the allocated memory block. Returns NULL if memory allocation failed.
  */
 unsigned char *allouer_pixels(entete_bmp *entete)
 {
-    // With BMP pixel data, each pixel requires 3 bytes (24 bits for red, green, and blue)
-    unsigned char *pixels = malloc(entete->bitmap.taille_donnees_image * sizeof(unsigned char));
+    uint64_t taille = taille_pixels(entete);
+    if (taille > SIZE_MAX)
+    {
+        return NULL;  // the image cannot even be addressed, use the streaming mode
+    }
+
+    unsigned char *pixels = malloc(taille * sizeof(unsigned char));
     return pixels;  // return the allocated array
 }
 
@@ -243,8 +442,7 @@ int lire_pixels(int fd, entete_bmp *entete, unsigned char *pixels)
     lseek(fd, entete->fichier.offset_donnees, SEEK_SET);
 
     // read the pixel data into the pixels array
-    uint32_t result = read(fd, pixels, entete->bitmap.taille_donnees_image);
-    if (result != entete->bitmap.taille_donnees_image)
+    if (lire_exactement(fd, pixels, taille_pixels(entete)) == -1)
     {
         return -1;  // return -1 if failed to read
     }
@@ -255,9 +453,8 @@ int lire_pixels(int fd, entete_bmp *entete, unsigned char *pixels)
 /**
  * @brief Writes pixel data to a file descriptor.
  *
- * This function moves the file cursor to the position where the pixel data begins
- * and writes the pixel data from the pixels array. It returns -1 if failed to write,
- * otherwise it returns 0.
+ * This function writes the pixel data from the pixels array at the position where the pixel data begins.
+ * It returns -1 if failed to write, otherwise it returns 0.
  *
  * @param fd The file descriptor of the file to write the pixel data.
  * @param entete Pointer to the entete_bmp structure containing file and bitmap headers.
@@ -266,18 +463,22 @@ int lire_pixels(int fd, entete_bmp *entete, unsigned char *pixels)
  */
 int ecrire_pixels(int fd, entete_bmp *entete, unsigned char *pixels)
 {
-    // move the file cursor to the position where the pixel data begins
-    lseek(fd, entete->fichier.offset_donnees, SEEK_SET);
+    return ecrire_pixels_vue(fd, entete, pixels, taille_ligne(entete));
+}
 
-    // write the pixel data from the pixels array
-    uint32_t result = write(fd, pixels, entete->bitmap.taille_donnees_image);
-    if (result != entete->bitmap.taille_donnees_image)
-    {
-        return -1;  // return -1 if failed to write
-    }
+// Point filters, instantiated for every pixel format by DEFINIR_NOYAUX (see bmp_noyaux.h). The filters
+// working on each channel alone are lookup tables (see bmp_tables.h), black and white mixes the channels.
+DEFINIR_NOYAUX(noir_et_blanc,
+               unsigned char average = (x[0] + x[1] + x[2]) / 3;
+               x[0] = x[1] = x[2] = average;
+)
 
-    return 0;
-}
+DEFINIR_NOYAUX(tables,
+               const tables_canaux *t = contexte;
+               x[0] = t->canaux[0][x[0]];
+               x[1] = t->canaux[1][x[1]];
+               x[2] = t->canaux[2][x[2]];
+)
 
 /**
 * @brief Sets the blue and green channels of the image pixels to 0, leaving the red channel unmodified.
@@ -289,23 +490,11 @@ int ecrire_pixels(int fd, entete_bmp *entete, unsigned char *pixels)
 * @param entete A pointer to the entete_bmp structure that contains information about the image.
 * @param pixels A pointer to the image pixels.
 *
-* @note The function assumes that the image is in 24-bit RGB format, where pixels are stored consecutively in a 1D array.
-* Each pixel is represented by 3 bytes, with the channel order of Blue, Green, and Red.
+* @note Paletted images are modified through their palette, the pixel indices are left untouched.
 */
 void rouge(entete_bmp *entete, unsigned char *pixels)
 {
-    uint32_t padding = (4 - (entete->bitmap.largeur * 3) % 4) % 4; // line padding calculation
-    for (uint32_t line = 0; line < entete->bitmap.hauteur; line++)
-    {
-        uint32_t lineoff = line * entete->bitmap.largeur * 3 + line * padding;
-        for (uint32_t col = 0; col < entete->bitmap.largeur; col++)
-        {
-            uint32_t x = lineoff + col * 3;
-            pixels[x] = 0;     // blue
-            pixels[x + 1] = 0; // green
-            // leaving red channel pixels[x + 2] unmodified
-        }
-    }
+    appliquer_filtre_ponctuel("-r", entete, pixels);
 }
 
 /**
@@ -320,18 +509,7 @@ void rouge(entete_bmp *entete, unsigned char *pixels)
  */
 void negatif(entete_bmp *entete, unsigned char *pixels)
 {
-    uint32_t padding = (4 - (entete->bitmap.largeur * 3) % 4) % 4; // line padding
-    for (uint32_t line = 0; line < entete->bitmap.hauteur; line++)
-    {
-        uint32_t lineoff = line * entete->bitmap.largeur * 3 + line * padding;
-        for (uint32_t col = 0; col < entete->bitmap.largeur; col++)
-        {
-            uint32_t x = lineoff + col * 3;
-            pixels[x] = ~pixels[x]; // Invert blue component
-            pixels[x + 1] = ~pixels[x + 1]; // Invert green component
-            pixels[x + 2] = ~pixels[x + 2]; // Invert red component
-        }
-    }
+    appliquer_filtre_ponctuel("-n", entete, pixels);
 }
 
 /**
@@ -346,103 +524,436 @@ void negatif(entete_bmp *entete, unsigned char *pixels)
  */
 void noir_et_blanc(entete_bmp *entete, unsigned char *pixels)
 {
-    uint32_t padding = (4 - (entete->bitmap.largeur * 3) % 4) % 4; // line padding
-    for (uint32_t line = 0; line < entete->bitmap.hauteur; line++)
+    noir_et_blanc_vue(entete, pixels, taille_ligne(entete), NULL);
+}
+
+/**
+ * @brief Replaces every channel of each pixel of a view by its entry in the lookup table of the channel.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ * @param tables The lookup tables of the blue, green and red channels.
+ *
+ * @note Paletted images are modified through their palette, the pixel indices are left untouched.
+ */
+void appliquer_tables(entete_bmp *entete, unsigned char *pixels, size_t pas, const tables_canaux *tables)
+{
+    tables_vue(entete, pixels, pas, tables);
+}
+
+/**
+ * @brief Updates the sizes stored in the header after a change of the image dimensions.
+ *
+ * @param entete Pointer to the header to update.
+ */
+void ajuster_tailles(entete_bmp *entete)
+{
+    entete->bitmap.taille_donnees_image = taille_ligne(entete) * entete->bitmap.hauteur;
+    entete->fichier.taille_fichier = entete->fichier.offset_donnees + entete->bitmap.taille_donnees_image;
+}
+
+/**
+ * @brief Keeps a rectangle of the image without moving any pixel.
+ *
+ * Only the header and the position of the first row change: the returned pointer designates the first pixel
+ * of the rectangle and consecutive rows stay `pas` bytes apart, as in the original buffer. The coordinates are
+ * those of the displayed image, whose origin is the top-left corner, while rows are stored bottom-up.
+ *
+ * @param entete Pointer to the header of the image, updated with the dimensions of the rectangle.
+ * @param pixels Pointer to the first row of the image.
+ * @param pas Number of bytes between two consecutive rows, negative if the view is upside down.
+ * @param x Column of the left edge of the rectangle.
+ * @param y Row of the top edge of the rectangle.
+ * @param largeur Width of the rectangle.
+ * @param hauteur Height of the rectangle.
+ * @return Pointer to the first row of the rectangle, or NULL if it does not fit in the image.
+ */
+unsigned char *rogner(entete_bmp *entete, unsigned char *pixels, ptrdiff_t pas, uint32_t x, uint32_t y,
+                      uint32_t largeur, uint32_t hauteur)
+{
+    if (largeur == 0 || hauteur == 0 || x > entete->bitmap.largeur || largeur > entete->bitmap.largeur - x
+        || y > entete->bitmap.hauteur || hauteur > entete->bitmap.hauteur - y)
+    {
+        return NULL;  // the rectangle is not inside the image
+    }
+
+    // la ligne du bas du rectangle est la première dans le fichier
+    uint32_t premiere = entete->bitmap.hauteur - y - hauteur;
+
+    entete->bitmap.largeur = largeur;
+    entete->bitmap.hauteur = hauteur;
+    ajuster_tailles(entete);
+
+    return pixels + premiere * pas + (size_t) x * octets_par_pixel(entete);
+}
+
+/**
+ * @brief Keeps the upper or lower half of the image without moving any pixel.
+ *
+ * @param entete Pointer to the header of the bitmap image, updated with the new height and sizes.
+ * @param pixels Pointer to the first row of the bitmap image.
+ * @param pas Number of bytes between two consecutive rows, negative if the view is upside down.
+ * @param sup Indicator whether to keep the upper half of the image.
+ * @return Pointer to the first row of the kept half.
+ */
+unsigned char *moitie(entete_bmp *entete, unsigned char *pixels, ptrdiff_t pas, int sup)
+{
+    uint32_t half_height = entete->bitmap.hauteur / 2;
+
+    // les lignes sont stockées de bas en haut, la moitié supérieure est la seconde moitié du tableau
+    uint32_t premiere = sup ? half_height : 0;
+
+    entete->bitmap.hauteur = half_height;
+    ajuster_tailles(entete);
+
+    return pixels + premiere * pas;
+}
+
+/**
+ * @brief Writes rows at the current position of a file descriptor, padding included.
+ *
+ * The rows are gathered with writev straight from the buffer they live in, the padding coming from a
+ * static block of zeros, so that neither cropped nor reordered rows need to be copied first.
+ *
+ * @param fd The file descriptor to write to.
+ * @param pixels Pointer to the first row to write.
+ * @param pas Signed number of bytes between two consecutive rows in the buffer.
+ * @param entete Header describing the rows written (width and height).
+ * @return 0 on success, -1 on failure.
+ */
+int ecrire_lignes(int fd, const unsigned char *pixels, ptrdiff_t pas, const entete_bmp *entete)
+{
+    static const unsigned char zeros[4] = {0};
+    size_t octets = (size_t) entete->bitmap.largeur * octets_par_pixel(entete);
+    size_t padding = taille_ligne(entete) - octets;
+    struct iovec vecteurs[2 * LIGNES_PAR_WRITEV];
+
+    for (uint32_t line = 0; line < entete->bitmap.hauteur;)
     {
-        uint32_t lineoff = line * entete->bitmap.largeur * 3 + line * padding;
-        for (uint32_t col = 0; col < entete->bitmap.largeur; col++)
+        int nb = 0;
+        size_t total = 0;
+
+        for (; nb < 2 * LIGNES_PAR_WRITEV && line < entete->bitmap.hauteur; line++)
         {
-            uint32_t x = lineoff + col * 3;
-            unsigned char average = (pixels[x] + pixels[x + 1] + pixels[x + 2]) / 3;
-            pixels[x] = pixels[x + 1] = pixels[x + 2] = average;
+            vecteurs[nb].iov_base = (void *) (pixels + line * pas);
+            vecteurs[nb++].iov_len = octets;
+            if (padding)
+            {
+                vecteurs[nb].iov_base = (void *) zeros;
+                vecteurs[nb++].iov_len = padding;
+            }
+            total += octets + padding;
+        }
+
+        ssize_t result = writev(fd, vecteurs, nb);
+        if (result < 0 || (size_t) result != total)
+        {
+            return -1;  // return -1 if failed to write
         }
     }
+
+    return 0;
 }
 
 /**
- * @brief Splits the given bitmap image into two halves and updates the header accordingly.
+ * @brief Writes the pixel data of a view of an image buffer to a file descriptor.
  *
- * @param entete Pointer to the header of the bitmap image.
- * @param pixels Pointer to the pixel data of the bitmap image.
- * @param sup Indicator whether to copy the upper half of the image.
+ * Contiguous pixels are written with a single pwrite at the position of the pixel data, other views are
+ * gathered row by row with ecrire_lignes.
  *
- * This function splits the given bitmap image into two halves - either the upper half or the lower half.
- * It calculates the padding required for each row of pixels, allocates memory for the new image,
- * and copies the appropriate half of the image to the new memory space.
- * It then updates the header to reflect the new image height, and finally copies the new pixels back to the original pixel array
- * and frees the memory allocated for the new image.
+ * @param fd The file descriptor of the file to write the pixel data.
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Signed number of bytes between two consecutive rows in the buffer.
+ * @return If failed to write, returns -1. Otherwise, returns 0.
+ */
+int ecrire_pixels_vue(int fd, const entete_bmp *entete, const unsigned char *pixels, ptrdiff_t pas)
+{
+    if (pas == (ptrdiff_t) taille_ligne(entete))
+    {
+        const unsigned char *curseur = pixels;
+        size_t reste = taille_pixels(entete);
+        off_t position = entete->fichier.offset_donnees;
+
+        while (reste > 0)
+        {
+            ssize_t result = pwrite(fd, curseur, reste, position);
+            if (result < 0)
+            {
+                return -1;  // return -1 if failed to write
+            }
+            curseur += result;
+            reste -= result;
+            position += result;
+        }
+
+        return 0;
+    }
+
+    // move the file cursor to the position where the pixel data begins
+    if (lseek(fd, entete->fichier.offset_donnees, SEEK_SET) == (off_t) -1)
+    {
+        return -1;
+    }
+
+    return ecrire_lignes(fd, pixels, pas, entete);
+}
+
+/**
+ * @brief Reads the argument of the --crop option.
  *
- * @note The original pixel data (passed to the function) will be modified.
+ * @param argument The argument, in the form "x,y,w,h".
+ * @param x Receives the column of the left edge.
+ * @param y Receives the row of the top edge.
+ * @param largeur Receives the width.
+ * @param hauteur Receives the height.
+ * @return 0 on success, -1 if the argument is malformed.
  */
-void moitie(entete_bmp *entete, unsigned char *pixels, int sup)
+int lire_rectangle(const char *argument, uint32_t *x, uint32_t *y, uint32_t *largeur, uint32_t *hauteur)
 {
-    uint32_t padding = (4 - (entete->bitmap.largeur * 3) % 4) % 4; // calculer le padding
-    uint32_t bytes_per_row = entete->bitmap.largeur * 3 + padding;
-    uint32_t half_height = entete->bitmap.hauteur / 2;
-    unsigned char *newPixels;
+    char fin;
 
-    // allouer un espace pour la nouvelle image
-    newPixels = (unsigned char *) malloc(half_height * bytes_per_row * sizeof(unsigned char));
+    if (argument == NULL || sscanf(argument, "%" SCNu32 ",%" SCNu32 ",%" SCNu32 ",%" SCNu32 "%c",
+                                   x, y, largeur, hauteur, &fin) != 4)
+    {
+        return -1;
+    }
+
+    return 0;
+}
 
-    // si sup vaut 1, copier la moitié supérieure de l'image
-    if (sup)
+/**
+ * @brief Unpacks a view of an image into a working buffer of 4-byte pixels (blue, green, red, alpha).
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows of the view.
+ * @param travail Buffer of largeur * hauteur pixels receiving the unpacked rows, without padding.
+ * @return 0 on success, -1 if the format cannot be unpacked (paletted images).
+ */
+int deballer_pixels(const entete_bmp *entete, const unsigned char *pixels, size_t pas, uint32_t *travail)
+{
+    format_pixels format = format_image(entete);
+    uint32_t largeur = entete->bitmap.largeur;
+
+    if (format == FORMAT_PALETTE_8 || format == FORMAT_INCONNU)
+        return -1;
+
+    for (uint32_t line = 0; line < entete->bitmap.hauteur; line++)
     {
-        for (uint32_t i = 0; i < half_height; i++)
+        const unsigned char *source = pixels + line * pas;
+        unsigned char *destination = (unsigned char *) (travail + (size_t) line * largeur);
+
+        if (format == FORMAT_BGRA_32)
+        {
+            memcpy(destination, source, (size_t) largeur * 4);
+            continue;
+        }
+
+        for (uint32_t col = 0; col < largeur; col++, destination += 4)
         {
-            for (uint32_t j = 0; j < bytes_per_row; j++)
+            if (format == FORMAT_BGR_24)
             {
-                newPixels[i * bytes_per_row + j] = pixels[(i + half_height) * bytes_per_row + j];
+                memcpy(destination, source + col * 3, 3);
+            } else
+            {
+                int bits_vert = format == FORMAT_RGB_565 ? 6 : 5;
+                uint16_t valeur = source[col * 2] | source[col * 2 + 1] << 8;
+                destination[0] = ETENDRE_CANAL(valeur & 0x1F, 5);
+                destination[1] = ETENDRE_CANAL((valeur >> 5) & ((1 << bits_vert) - 1), bits_vert);
+                destination[2] = ETENDRE_CANAL((valeur >> (5 + bits_vert)) & 0x1F, 5);
             }
+            destination[3] = 0;
         }
-    } else
-    { // sinon, copier la moitié inférieure de l'image
-        for (uint32_t i = 0; i < half_height; i++)
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Packs a working buffer of 4-byte pixels back into a view of an image.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows of the view.
+ * @param travail Buffer of largeur * hauteur pixels, as filled by deballer_pixels.
+ */
+void emballer_pixels(const entete_bmp *entete, unsigned char *pixels, size_t pas, const uint32_t *travail)
+{
+    format_pixels format = format_image(entete);
+    uint32_t largeur = entete->bitmap.largeur;
+
+    for (uint32_t line = 0; line < entete->bitmap.hauteur; line++)
+    {
+        unsigned char *destination = pixels + line * pas;
+        const unsigned char *source = (const unsigned char *) (travail + (size_t) line * largeur);
+
+        if (format == FORMAT_BGRA_32)
         {
-            for (uint32_t j = 0; j < bytes_per_row; j++)
+            memcpy(destination, source, (size_t) largeur * 4);
+            continue;
+        }
+
+        for (uint32_t col = 0; col < largeur; col++, source += 4)
+        {
+            if (format == FORMAT_BGR_24)
+            {
+                memcpy(destination + col * 3, source, 3);
+            } else if (format == FORMAT_RGB_555 || format == FORMAT_RGB_565)
             {
-                newPixels[i * bytes_per_row + j] = pixels[i * bytes_per_row + j];
+                int bits_vert = format == FORMAT_RGB_565 ? 6 : 5;
+                uint16_t valeur = source[0] >> 3 | (source[1] >> (8 - bits_vert)) << 5
+                                  | (source[2] >> 3) << (5 + bits_vert);
+                destination[col * 2] = valeur & 0xFF;
+                destination[col * 2 + 1] = valeur >> 8;
             }
         }
     }
+}
 
-    // mettre à jour l'entête pour refléter la nouvelle hauteur
-    entete->bitmap.hauteur = half_height;
-
-    // copier les nouveaux pixels dans l'ancien tableau de pixels
-    memcpy(pixels, newPixels, half_height * bytes_per_row);
-    free(newPixels); // libérer la mémoire allouée pour les nouveaux pixels
+/**
+ * @brief Applies a point filter (one that only looks at a pixel at a time) to the pixels.
+ *
+ * @param option The command-line option naming the filter ("-r", "-n" or "-b").
+ * @param entete Pointer to the header describing the pixels.
+ * @param pixels Pointer to the pixel data.
+ * @return 0 if the filter was applied, -1 if the option is not a point filter.
+ */
+int appliquer_filtre_ponctuel(const char *option, entete_bmp *entete, unsigned char *pixels)
+{
+    return appliquer_filtre_vue(option, entete, pixels, taille_ligne(entete));
 }
 
 /**
- * @brief This function modifies a BMP file based on the specified operations.
+ * @brief Applies a point filter to a view of an image buffer.
  *
- * @param argc The number of command-line arguments.
- * @param argv An array of command-line arguments.
- * @return int Returns 0 if the BMP file was modified successfully, -1 otherwise.
+ * The rows of the view do not need to be contiguous, as after a crop.
+ *
+ * @param option The command-line option naming the filter.
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ * @return 0 if the filter was applied, -1 if the option is not a point filter.
  */
-int run_modif_bmp(int argc, char *argv[])
+int appliquer_filtre_vue(const char *option, entete_bmp *entete, unsigned char *pixels, size_t pas)
 {
-    if (argc < 2)
+    tables_canaux tables;
+
+    if (strcmp(option, "-b") == 0)
+    {
+        noir_et_blanc_vue(entete, pixels, pas, NULL);
+    } else if (arguments_operation(option) == 0)
+    {
+        tables_identite(&tables);
+        composer_operation(&tables, option, NULL);
+        appliquer_tables(entete, pixels, pas, &tables);
+    } else
     {
-        printf("Error: Missing input or output file for --modif_bmp operation\n");
         return -1;
     }
 
-    char *input = argv[1];
-    char *output = argv[2];
+    return 0;
+}
+
+/**
+ * @brief Makes sure a reusable buffer can hold the pixel data of an image.
+ *
+ * The buffer only grows, so that processing many images of similar sizes reallocates it a few times at most.
+ *
+ * @param tampon The reusable buffer.
+ * @param entete The header of the image.
+ * @return Pointer to the pixel storage, or NULL if memory allocation failed.
+ */
+unsigned char *reserver_pixels(tampon_pixels *tampon, const entete_bmp *entete)
+{
+    uint64_t taille = taille_pixels(entete);
+    if (taille > SIZE_MAX)
+    {
+        return NULL;  // the image cannot even be addressed, use the streaming mode
+    }
+
+    if (taille > tampon->capacite)
+    {
+        unsigned char *donnees = realloc(tampon->donnees, taille);
+        if (!donnees)
+        {
+            return NULL;  // the old buffer is kept and freed by liberer_pixels
+        }
+        tampon->donnees = donnees;
+        tampon->capacite = taille;
+    }
+
+    return tampon->donnees;
+}
 
+/**
+ * @brief Frees a reusable pixel buffer.
+ *
+ * @param tampon The reusable buffer.
+ */
+void liberer_pixels(tampon_pixels *tampon)
+{
+    free(tampon->donnees);
+    tampon->donnees = NULL;
+    tampon->capacite = 0;
+}
+
+/**
+ * @brief Returns the rows of a view in memory order, for the filters that do not depend on the order of the rows.
+ *
+ * @param image Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows, negative if the view is upside down.
+ * @param pas_memoire Receives the absolute value of pas.
+ * @return Pointer to the row of the view with the lowest address.
+ */
+static unsigned char *vue_memoire(const entete_bmp *image, unsigned char *pixels, ptrdiff_t pas, size_t *pas_memoire)
+{
+    *pas_memoire = pas < 0 ? (size_t) -pas : (size_t) pas;
+    return pas < 0 && image->bitmap.hauteur > 0 ? pixels + (image->bitmap.hauteur - 1) * pas : pixels;
+}
+
+/**
+ * @brief Replaces the content of a reusable buffer by pixels produced by a filter.
+ *
+ * @param tampon The reusable buffer, whose former pixels are freed.
+ * @param pixels The allocated pixels, owned by the buffer from now on.
+ * @param entete The header of the new pixels.
+ * @return The new pixels.
+ */
+static unsigned char *remplacer_pixels(tampon_pixels *tampon, unsigned char *pixels, const entete_bmp *entete)
+{
+    free(tampon->donnees);
+    tampon->donnees = pixels;
+    tampon->capacite = taille_pixels(entete);
+    return pixels;
+}
+
+/**
+ * @brief Modifies one BMP file in memory.
+ *
+ * @param input Path of the input image.
+ * @param output Path of the output image.
+ * @param options The filter options, in command-line order; an unknown option is an error.
+ * @param nb_options The number of options.
+ * @param tampon Buffer receiving the pixels, reused from one call to the next.
+ * @param entete Receives the header of the input image.
+ * @return 0 on success, -1 on error.
+ */
+int modifier_bmp(const char *input, const char *output, char **options, int nb_options, tampon_pixels *tampon,
+                 entete_bmp *entete)
+{
     // Open the input file
     FILE *in = fopen(input, "rb");
     if (!in)
     {
         printf("Error: Cannot open input file %s\n", input);
-        fclose(in);
         return -1;
     }
 
     // Read the BMP header and the pixel data
-    entete_bmp entete;
-    if (lire_entete(fileno(in), &entete) == -1)
+    if (lire_entete(fileno(in), entete) == -1)
     {
         printf("Error: Cannot read BMP header from input file %s\n", input);
         fclose(in);
@@ -450,18 +961,28 @@ int run_modif_bmp(int argc, char *argv[])
     }
 
     // Verify the depth of the BMP file
-    if (!verifier_entete(&entete))
+    if (!verifier_entete(entete))
+    {
+        printf("Error: Invalid BMP file %s. Expecting a non-empty image of 8, 16, 24 or 32 bits and pixel data for every row.\n", input);
+        fclose(in);
+        return -1;
+    }
+
+    unsigned char *pixels = reserver_pixels(tampon, entete);
+    if (!pixels)
     {
-        printf("Error: Invalid depth in BMP file %s. Expecting 24 bits.\n", input);
+        // the streaming mode only helps when a whole non-empty image does not fit in memory
+        if (taille_pixels(entete) > 0)
+            printf("Error: Cannot allocate pixel data for %s, try %s\n", input, OPTION_FLUX);
+        else
+            printf("Error: Cannot allocate pixel data for %s\n", input);
         fclose(in);
         return -1;
     }
 
-    unsigned char *pixels = allouer_pixels(&entete);
-    if (lire_pixels(fileno(in), &entete, pixels) == -1)
+    if (lire_pixels(fileno(in), entete, pixels) == -1)
     {
         printf("Error: Cannot read pixel data from input file %s\n", input);
-        free(pixels);
         fclose(in);
         return -1;
     }
@@ -469,24 +990,157 @@ int run_modif_bmp(int argc, char *argv[])
     // Close the input file
     fclose(in);
 
+    // Cropping and vertical mirrors never move pixels: the image is a view of the buffer whose rows are pas
+    // bytes apart, pas being negative when the view walks the buffer backwards
+    entete_bmp image = *entete;
+    ptrdiff_t pas = (ptrdiff_t) taille_ligne(&image);
+
     // Apply filters in the order of arguments
-    for (int i = 3; i < argc; i++)
+    for (int i = 0; i < nb_options; i++)
     {
-        if (strcmp(argv[i], "-r") == 0)
+        size_t pas_memoire;
+        unsigned char *memoire = vue_memoire(&image, pixels, pas, &pas_memoire);
+
+        if (arguments_operation(options[i]) != -1)
         {
-            rouge(&entete, pixels);
-        } else if (strcmp(argv[i], "-n") == 0)
+            // consecutive point operations are composed and applied in a single pass
+            chaine_ponctuelle chaine = {0};
+            int consommees = compiler_chaine(&chaine, options + i, nb_options - i);
+
+            if (consommees == -1)
+            {
+                printf("Error: Invalid point operation in the options starting at %s\n", options[i]);
+                liberer_chaine(&chaine);
+                return -1;
+            }
+            executer_chaine(&chaine, &image, memoire, pas_memoire);
+            liberer_chaine(&chaine);
+            i += consommees - 1;
+        } else if (strcmp(options[i], "-s") == 0)
         {
-            negatif(&entete, pixels);
-        } else if (strcmp(argv[i], "-b") == 0)
+            pixels = moitie(&image, pixels, pas, 1);
+        } else if (strcmp(options[i], "-i") == 0)
         {
-            noir_et_blanc(&entete, pixels);
-        } else if (strcmp(argv[i], "-s") == 0)
+            pixels = moitie(&image, pixels, pas, 0);
+        } else if (strcmp(options[i], OPTION_ROGNER) == 0)
         {
-            moitie(&entete, pixels, 1);
-        } else if (strcmp(argv[i], "-i") == 0)
+            uint32_t x, y, largeur, hauteur;
+            unsigned char *rectangle = NULL;
+
+            if (i + 1 < nb_options && lire_rectangle(options[i + 1], &x, &y, &largeur, &hauteur) == 0)
+            {
+                rectangle = rogner(&image, pixels, pas, x, y, largeur, hauteur);
+            }
+            if (!rectangle)
+            {
+                printf("Error: %s expects a rectangle x,y,w,h inside the image\n", OPTION_ROGNER);
+                return -1;
+            }
+            pixels = rectangle;
+            i++;
+        } else if (strcmp(options[i], OPTION_FLOU) == 0)
+        {
+            char *fin = NULL;
+            long rayon = i + 1 < nb_options ? strtol(options[i + 1], &fin, 10) : 0;
+
+            if (!fin || *fin != '\0' || rayon < 1 || rayon > RAYON_FLOU_MAX)
+            {
+                printf("Error: %s expects a radius between 1 and %d\n", OPTION_FLOU, RAYON_FLOU_MAX);
+                return -1;
+            }
+            if (flou(&image, memoire, pas_memoire, (uint32_t) rayon) == -1)
+            {
+                printf("Error: Cannot blur %s, paletted images are not supported\n", input);
+                return -1;
+            }
+            i++;
+        } else if (strcmp(options[i], OPTION_REDIMENSIONNER) == 0)
+        {
+            uint32_t largeur, hauteur;
+            mode_redimension mode;
+            unsigned char *redimensionnee = NULL;
+
+            if (i + 1 < nb_options && lire_dimensions(options[i + 1], &largeur, &hauteur, &mode) == 0)
+            {
+                redimensionnee = redimensionner(&image, memoire, pas_memoire, largeur, hauteur, mode);
+            }
+            if (!redimensionnee)
+            {
+                printf("Error: %s expects dimensions WxH[:area|:lanczos] of at most %d pixels, "
+                       "paletted images are not supported\n", OPTION_REDIMENSIONNER, DIMENSION_MAX);
+                return -1;
+            }
+
+            // the resampled image replaces the input in the reusable buffer, upside down if the view was
+            int retournee = pas < 0;
+            pixels = remplacer_pixels(tampon, redimensionnee, &image);
+            pas = (ptrdiff_t) taille_ligne(&image);
+            if (retournee)
+                pixels = miroir_vertical(&image, pixels, &pas);
+            i++;
+        } else if (strcmp(options[i], OPTION_STATISTIQUES) == 0)
+        {
+            statistiques_bmp statistiques;
+
+            if (calculer_statistiques(&image, memoire, pas_memoire, &statistiques) == -1)
+            {
+                printf("Error: Cannot compute the statistics of %s\n", input);
+                return -1;
+            }
+            afficher_statistiques(input, &statistiques);
+        } else if (strcmp(options[i], OPTION_NIVEAUX) == 0)
+        {
+            if (niveaux_automatiques(&image, memoire, pas_memoire) == -1)
+            {
+                printf("Error: Cannot adjust the levels of %s\n", input);
+                return -1;
+            }
+        } else if (strcmp(options[i], OPTION_NETTETE) == 0)
+        {
+            if (nettete(&image, memoire, pas_memoire) == -1)
+            {
+                printf("Error: Cannot sharpen %s, paletted images are not supported\n", input);
+                return -1;
+            }
+        } else if (strcmp(options[i], OPTION_MIROIR_HORIZONTAL) == 0)
+        {
+            miroir_horizontal(&image, pixels, pas);
+        } else if (strcmp(options[i], OPTION_MIROIR_VERTICAL) == 0)
+        {
+            pixels = miroir_vertical(&image, pixels, &pas);
+        } else if (strcmp(options[i], OPTION_PIVOTER) == 0)
+        {
+            char *fin = NULL;
+            long angle = i + 1 < nb_options ? strtol(options[i + 1], &fin, 10) : 0;
+
+            if (!fin || *fin != '\0' || (angle != 90 && angle != 180 && angle != 270))
+            {
+                printf("Error: %s expects an angle of 90, 180 or 270 degrees\n", OPTION_PIVOTER);
+                return -1;
+            }
+
+            if (angle == 180)
+            {
+                // a half turn is both mirrors, the vertical one being free
+                miroir_horizontal(&image, pixels, pas);
+                pixels = miroir_vertical(&image, pixels, &pas);
+            } else
+            {
+                unsigned char *pivotee = pivoter(&image, pixels, pas, (int) angle);
+                if (!pivotee)
+                {
+                    printf("Error: Cannot allocate the rotated pixels of %s\n", input);
+                    return -1;
+                }
+                pixels = remplacer_pixels(tampon, pivotee, &image);
+                pas = (ptrdiff_t) taille_ligne(&image);
+            }
+            i++;
+        } else
         {
-            moitie(&entete, pixels, 0);
+            // an option silently skipped would give an image the user did not ask for
+            printf("Error: Unknown option %s\n", options[i]);
+            return -1;
         }
     }
 
@@ -495,31 +1149,82 @@ int run_modif_bmp(int argc, char *argv[])
     if (!out)
     {
         printf("Error: Cannot open output file %s\n", output);
-        free(pixels);
         return -1;
     }
 
     // Write the BMP header and the pixel data
-    if (ecrire_entete(fileno(out), &entete) == -1)
+    if (ecrire_entete(fileno(out), &image) == -1)
     {
         printf("Error: Cannot write BMP header to output file %s\n", output);
-        free(pixels);
         fclose(out);
         return -1;
     }
 
-    if (ecrire_pixels(fileno(out), &entete, pixels) == -1)
+    if (ecrire_pixels_vue(fileno(out), &image, pixels, pas) == -1)
     {
         printf("Error: Cannot write pixel data to output file %s\n", output);
-        free(pixels);
         fclose(out);
         return -1;
     }
 
-    // Close the output file and free pixel memory
+    // Close the output file
     fclose(out);
-    free(pixels);
+    return 0;
+}
+
+/**
+ * @brief This function modifies a BMP file based on the specified operations.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line arguments.
+ * @return int Returns 0 if the BMP file was modified successfully, -1 otherwise.
+ */
+int run_modif_bmp(int argc, char *argv[])
+{
+    // Many images are processed by a pool of threads in a single process
+    if (argc > 1 && strcmp(argv[1], OPTION_LOT) == 0)
+    {
+        return run_modif_bmp_lot(argc - 1, argv + 1);
+    }
+
+    // The filters are checked against known outputs and timed
+    if (argc > 1 && strcmp(argv[1], OPTION_BANC) == 0)
+    {
+        return run_modif_bmp_banc(argc - 1, argv + 1);
+    }
+
+    if (argc < 3)
+    {
+        printf("Error: Missing input or output file for --modif_bmp operation\n");
+        return -1;
+    }
+
+    char *input = argv[1];
+    char *output = argv[2];
+
+    // Images that do not fit in memory are processed band by band
+    int flux = 0;
+    for (int i = 3; i < argc; i++)
+    {
+        if (strcmp(argv[i], OPTION_FLUX) == 0)
+        {
+            flux = 1;
+        }
+    }
+
+    tampon_pixels tampon = {NULL, 0};
+    entete_bmp entete;
+    int resultat = flux ? modif_bmp_flux(input, output, argv + 3, argc - 3)
+                        : modifier_bmp(input, output, argv + 3, argc - 3, &tampon, &entete);
+
+    // free pixel memory
+    liberer_pixels(&tampon);
+
+    if (resultat == -1)
+    {
+        return -1;
+    }
 
     printf("BMP file modified successfully. Output written to %s.\n", output);
     return 0;
-}
\ No newline at end of file
+}
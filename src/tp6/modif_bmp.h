@@ -10,6 +10,13 @@
  on utilise les types définis dans stdint.h
 */
 #include <stdint.h>
+#include <stddef.h>
+
+/// Option of --modif_bmp keeping a rectangle x,y,w,h of the image
+#define OPTION_ROGNER "--crop"
+
+/// Number of rows gathered by a single writev call (two vectors per row with the padding)
+#define LIGNES_PAR_WRITEV 512
 
 typedef struct
 {
@@ -34,12 +41,52 @@ typedef struct
     uint32_t nombre_de_couleurs_importantes; /* 0 */
 } entete_bitmap;
 
+/// Size of the file header
+#define TAILLE_ENTETE_FICHIER 14
+
+/// Size of the file header and of the smallest bitmap header, as read by lire_entete
+#define TAILLE_ENTETES 54
+
+/// Largest number of bytes kept between the headers and the pixels (larger headers, bit masks and palette)
+#define TAILLE_EXTENSION_MAX 2048
+
+/// Values of the compression field supported by the tool
+#define COMPRESSION_AUCUNE 0
+#define COMPRESSION_CHAMPS_BITS 3
+
 typedef struct
 {
     entete_fichier fichier;
     entete_bitmap bitmap;
+    // the bytes between the 54 bytes above and the pixels, copied as is to the output
+    uint32_t taille_extension;
+    unsigned char extension[TAILLE_EXTENSION_MAX];
 } entete_bmp;
 
+/// Pixel formats supported by the tool
+typedef enum
+{
+    FORMAT_INCONNU = 0,
+    FORMAT_PALETTE_8,  ///< 8-bit indices into a palette of blue, green, red, reserved entries
+    FORMAT_RGB_555,    ///< 16-bit pixels, 5 bits per channel
+    FORMAT_RGB_565,    ///< 16-bit pixels, 6 bits for green
+    FORMAT_BGR_24,     ///< 24-bit pixels, one byte per channel
+    FORMAT_BGRA_32     ///< 32-bit pixels, the fourth byte (alpha) is left untouched
+} format_pixels;
+
+/// A pixel buffer reused from one image to the next
+typedef struct
+{
+    unsigned char *donnees;  ///< pixel storage, only ever grown
+    size_t capacite;         ///< allocated size of donnees in bytes
+} tampon_pixels;
+
+/// Per-channel lookup tables of a point filter, indexed by the blue, green and red values of a pixel
+typedef struct
+{
+    unsigned char canaux[3][256];
+} tables_canaux;
+
 /**
  * @brief Reads two bytes from a file descriptor into a uint16_t variable.
  *
@@ -122,20 +169,90 @@ int ecrire_quatre_octets(int fd, uint32_t val);
 int ecrire_entete(int vers, entete_bmp *entete);
 
 /**
- * @brief Verifies if the header depth of a BMP image is 24 bits.
+ * @brief Determines the pixel format of a BMP image from its depth, compression and bit masks.
+ *
+ * @param entete Pointer to the BMP header structure.
+ * @return The pixel format, FORMAT_INCONNU if the tool does not support it.
+ */
+format_pixels format_image(const entete_bmp *entete);
+
+/**
+ * @brief Returns the number of bytes of one pixel.
+ *
+ * @param entete Pointer to the BMP header structure.
+ * @return The depth of the image divided by 8.
+ */
+uint32_t octets_par_pixel(const entete_bmp *entete);
+
+/**
+ * @brief Locates the palette of a paletted image in the header extension.
+ *
+ * @param entete Pointer to the BMP header structure.
+ * @param nombre Receives the number of colors of the palette.
+ * @return Pointer to the first entry of the palette.
+ */
+unsigned char *palette_image(entete_bmp *entete, uint32_t *nombre);
+
+/**
+ * @brief Verifies if the pixel format of a BMP image is supported.
  *
- * This function takes a pointer to the header of a BMP image and checks if the depth of the image is 24 bits.
+ * This function takes a pointer to the header of a BMP image and checks that it is not empty, that its pixels
+ * are 8-bit paletted, 16-bit, 24-bit or 32-bit, and that a non-zero `taille_donnees_image` covers every row
+ * (see taille_pixels).
  *
  * @param entete Pointer to the entete_bmp structure representing the BMP image header.
- * @return Returns 1 if the depth is 24 bits, otherwise returns 0.
+ * @return Returns 1 if the format is supported, otherwise returns 0.
  */
 int verifier_entete(const entete_bmp *entete);
 
+/**
+ * @brief Computes the size in bytes of one row of pixels, padding included.
+ *
+ * BMP rows are padded so that each of them starts on a 4-byte boundary.
+ *
+ * @param entete Pointer to the BMP header structure.
+ * @return The number of bytes occupied by one row in the file.
+ */
+size_t taille_ligne(const entete_bmp *entete);
+
+/**
+ * @brief Computes the size in bytes of the pixel data of a BMP image.
+ *
+ * The size is always derived from the width, the height and the row padding, never from
+ * `taille_donnees_image`, which may be 0 for uncompressed images or smaller than the rows.
+ *
+ * @param entete Pointer to the BMP header structure.
+ * @return The number of bytes of pixel data.
+ */
+uint64_t taille_pixels(const entete_bmp *entete);
+
+/**
+ * @brief Reads exactly `taille` bytes from a file descriptor.
+ *
+ * Loops over `read` until the requested amount has been read, so that large reads
+ * split by the kernel are not mistaken for errors.
+ *
+ * @param fd The file descriptor to read from.
+ * @param tampon The buffer receiving the data.
+ * @param taille The number of bytes to read.
+ * @return 0 on success, -1 on error or premature end of file.
+ */
+int lire_exactement(int fd, void *tampon, size_t taille);
+
+/**
+ * @brief Writes exactly `taille` bytes to a file descriptor.
+ *
+ * @param fd The file descriptor to write to.
+ * @param tampon The data to write.
+ * @param taille The number of bytes to write.
+ * @return 0 on success, -1 on error.
+ */
+int ecrire_exactement(int fd, const void *tampon, size_t taille);
+
 /**
  * @brief Allocates memory for pixel data in a BMP image.
  *
  * The function allocates memory for pixel data based on the size of the image.
- * Each pixel requires 3 bytes (24 bits for red, green, and blue).
  * The allocated memory should be freed by the caller when no longer needed.
  *
  * @param entete Pointer to the BMP file header and image header structure.
@@ -209,26 +326,177 @@ void negatif(entete_bmp *entete, unsigned char *pixels);
 void noir_et_blanc(entete_bmp *entete, unsigned char *pixels);
 
 /**
- * @brief Splits the given bitmap image into two halves and updates the header accordingly.
+ * @brief Replaces every channel of each pixel of a view by its entry in the lookup table of the channel.
  *
- * @param entete Pointer to the header of the bitmap image.
- * @param pixels Pointer to the pixel data of the bitmap image.
- * @param sup Indicator whether to copy the upper half of the image.
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ * @param tables The lookup tables of the blue, green and red channels.
+ *
+ * @note Paletted images are modified through their palette, the pixel indices are left untouched.
+ */
+void appliquer_tables(entete_bmp *entete, unsigned char *pixels, size_t pas, const tables_canaux *tables);
+
+/**
+ * @brief Updates the sizes stored in the header after a change of the image dimensions.
  *
- * This function splits the given bitmap image into two halves - either the upper half or the lower half.
- * It calculates the padding required for each row of pixels, allocates memory for the new image,
- * and copies the appropriate half of the image to the new memory space.
- * It then updates the header to reflect the new image height, and finally copies the new pixels back to the original pixel array
- * and frees the memory allocated for the new image.
+ * @param entete Pointer to the header to update.
+ */
+void ajuster_tailles(entete_bmp *entete);
+
+/**
+ * @brief Keeps a rectangle of the image without moving any pixel.
+ *
+ * Only the header and the position of the first row change, the rows of the rectangle stay `pas` bytes apart.
+ * The coordinates are those of the displayed image, whose origin is the top-left corner.
+ *
+ * @param entete Pointer to the header of the image, updated with the dimensions of the rectangle.
+ * @param pixels Pointer to the first row of the image.
+ * @param pas Number of bytes between two consecutive rows, negative if the view is upside down.
+ * @param x Column of the left edge of the rectangle.
+ * @param y Row of the top edge of the rectangle.
+ * @param largeur Width of the rectangle.
+ * @param hauteur Height of the rectangle.
+ * @return Pointer to the first row of the rectangle, or NULL if it does not fit in the image.
+ */
+unsigned char *rogner(entete_bmp *entete, unsigned char *pixels, ptrdiff_t pas, uint32_t x, uint32_t y,
+                      uint32_t largeur, uint32_t hauteur);
+
+/**
+ * @brief Keeps the upper or lower half of the image and updates the header accordingly.
  *
- * @note The original pixel data (passed to the function) will be modified.
+ * @param entete Pointer to the header of the bitmap image.
+ * @param pixels Pointer to the first row of the bitmap image.
+ * @param pas Number of bytes between two consecutive rows, negative if the view is upside down.
+ * @param sup Indicator whether to keep the upper half of the image.
+ * @return Pointer to the first row of the kept half.
+ *
+ * No pixel is copied: the kept half is a slice of the original rows, which is what gets written to the output.
  *
  * Example usage:
  * entete_bmp entete;
  * unsigned char pixels[100];
- * moitie(&entete, pixels, 1);
+ * unsigned char *haut = moitie(&entete, pixels, taille_ligne(&entete), 1);
+ */
+unsigned char *moitie(entete_bmp *entete, unsigned char *pixels, ptrdiff_t pas, int sup);
+
+/**
+ * @brief Writes rows at the current position of a file descriptor, padding included.
+ *
+ * The rows are gathered with writev straight from the buffer they live in.
+ *
+ * @param fd The file descriptor to write to.
+ * @param pixels Pointer to the first row to write.
+ * @param pas Signed number of bytes between two consecutive rows in the buffer.
+ * @param entete Header describing the rows written (width and height).
+ * @return 0 on success, -1 on failure.
+ */
+int ecrire_lignes(int fd, const unsigned char *pixels, ptrdiff_t pas, const entete_bmp *entete);
+
+/**
+ * @brief Writes the pixel data of a view of an image buffer to a file descriptor.
+ *
+ * @param fd The file descriptor of the BMP file.
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Signed number of bytes between two consecutive rows in the buffer.
+ * @return 0 if successful, -1 if failed to write.
+ */
+int ecrire_pixels_vue(int fd, const entete_bmp *entete, const unsigned char *pixels, ptrdiff_t pas);
+
+/**
+ * @brief Reads the argument of the --crop option.
+ *
+ * @param argument The argument, in the form "x,y,w,h".
+ * @param x Receives the column of the left edge.
+ * @param y Receives the row of the top edge.
+ * @param largeur Receives the width.
+ * @param hauteur Receives the height.
+ * @return 0 on success, -1 if the argument is malformed.
+ */
+int lire_rectangle(const char *argument, uint32_t *x, uint32_t *y, uint32_t *largeur, uint32_t *hauteur);
+
+/**
+ * @brief Unpacks a view of an image into a working buffer of 4-byte pixels (blue, green, red, alpha).
+ *
+ * Filters that mix neighbouring pixels work on this common layout whatever the format of the image.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows of the view.
+ * @param travail Buffer of largeur * hauteur pixels receiving the unpacked rows, without padding.
+ * @return 0 on success, -1 if the format cannot be unpacked (paletted images).
+ */
+int deballer_pixels(const entete_bmp *entete, const unsigned char *pixels, size_t pas, uint32_t *travail);
+
+/**
+ * @brief Packs a working buffer of 4-byte pixels back into a view of an image.
+ *
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows of the view.
+ * @param travail Buffer of largeur * hauteur pixels, as filled by deballer_pixels.
+ */
+void emballer_pixels(const entete_bmp *entete, unsigned char *pixels, size_t pas, const uint32_t *travail);
+
+/**
+ * @brief Applies a point filter (one that only looks at a pixel at a time) to the pixels.
+ *
+ * Point filters do not depend on neighbouring rows, so they can be applied to the whole
+ * image as well as to a band of rows described by a header whose height is the band height.
+ *
+ * For paletted images only the palette, stored in the header, is modified.
+ *
+ * @param option The command-line option naming the filter ("-r", "-n" or "-b").
+ * @param entete Pointer to the header describing the pixels.
+ * @param pixels Pointer to the pixel data.
+ * @return 0 if the filter was applied, -1 if the option is not a point filter.
+ */
+int appliquer_filtre_ponctuel(const char *option, entete_bmp *entete, unsigned char *pixels);
+
+/**
+ * @brief Applies a point filter to a view of an image buffer whose rows are `pas` bytes apart.
+ *
+ * @param option The command-line option naming the filter.
+ * @param entete Pointer to the header describing the view.
+ * @param pixels Pointer to the first row of the view.
+ * @param pas Number of bytes between two consecutive rows.
+ * @return 0 if the filter was applied, -1 if the option is not a point filter.
+ */
+int appliquer_filtre_vue(const char *option, entete_bmp *entete, unsigned char *pixels, size_t pas);
+
+/**
+ * @brief Makes sure a reusable buffer can hold the pixel data of an image.
+ *
+ * @param tampon The reusable buffer.
+ * @param entete The header of the image.
+ * @return Pointer to the pixel storage, or NULL if memory allocation failed.
+ */
+unsigned char *reserver_pixels(tampon_pixels *tampon, const entete_bmp *entete);
+
+/**
+ * @brief Frees a reusable pixel buffer.
+ *
+ * @param tampon The reusable buffer.
+ */
+void liberer_pixels(tampon_pixels *tampon);
+
+/**
+ * @brief Modifies one BMP file in memory.
+ *
+ * Reads the image into `tampon`, applies the options in order and writes the result.
+ * Errors are reported on the standard output, success is left to the caller.
+ *
+ * @param input Path of the input image.
+ * @param output Path of the output image.
+ * @param options The filter options, in command-line order; an unknown option is an error.
+ * @param nb_options The number of options.
+ * @param tampon Buffer receiving the pixels, reused from one call to the next.
+ * @param entete Receives the header of the input image.
+ * @return 0 on success, -1 on error.
  */
-void moitie(entete_bmp *entete, unsigned char *pixel, int sup);
+int modifier_bmp(const char *input, const char *output, char **options, int nb_options, tampon_pixels *tampon,
+                 entete_bmp *entete);
 
 /**
  * @brief This function modifies a BMP file based on the specified operations.